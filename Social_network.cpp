@@ -1,201 +1,241 @@
-#include <iostream>
-#include<bits/stdc++.h>
-#include <unordered_map>
-#include <vector>
-#include <queue>
-#include <set>
-#include <string>
-#include <climits>
-#include <iomanip>
-
-using namespace std;
-
-// Class to represent the social network
-class SocialNetwork {
-private:
-    unordered_map<string, vector<string>> adjacencyList; // Graph representation
-
-    // Helper function to find mutual friends
-    set<string> findMutualFriends(const string& user1, const string& user2) {
-        set<string> mutualFriends;
-        if (adjacencyList.find(user1) == adjacencyList.end() || adjacencyList.find(user2) == adjacencyList.end()) {
-            return mutualFriends;
-        }
-        set<string> friendsOfUser1(adjacencyList[user1].begin(), adjacencyList[user1].end());
-        for (const string& friendName : adjacencyList[user2]) {
-            if (friendsOfUser1.find(friendName) != friendsOfUser1.end()) {
-                mutualFriends.insert(friendName);
-            }
-        }
-        return mutualFriends;
-    }
-
-public:
-    // Add a new user to the network
-    void addUser(const string& user) {
-        if (adjacencyList.find(user) != adjacencyList.end()) {
-            cout << user << " is already in the network.\n";
-        } else {
-            adjacencyList[user] = {};
-            cout << user << " added to the network.\n";
-        }
-    }
-
-    // Add a friendship between two users
-    void addFriendship(const string& user1, const string& user2) {
-        if (user1 == user2) {
-            cout << "A user cannot be friends with themselves.\n";
-            return;
-        }
-
-        if (adjacencyList.find(user1) == adjacencyList.end() || adjacencyList.find(user2) == adjacencyList.end()) {
-            cout << "Both users must exist in the network to establish a friendship.\n";
-            return;
-        }
-
-        adjacencyList[user1].push_back(user2);
-        adjacencyList[user2].push_back(user1);
-        cout << "Friendship established between " << user1 << " and " << user2 << ".\n";
-    }
-
-    // Display the network
-    void displayNetwork() {
-        cout << "\n--- Social Network ---\n";
-        for (const auto& [user, friends] : adjacencyList) {
-            cout << user << ": ";
-            for (const string& friendName : friends) {
-                cout << friendName << " ";
-            }
-            cout << "\n";
-        }
-        cout << "-----------------------\n";
-    }
-
-    // Suggest friends for a user based on mutual friends
-    void suggestFriends(const string& user) {
-        if (adjacencyList.find(user) == adjacencyList.end()) {
-            cout << user << " does not exist in the network.\n";
-            return;
-        }
-
-        unordered_map<string, int> mutualFriendCount;
-        set<string> currentFriends(adjacencyList[user].begin(), adjacencyList[user].end());
-
-        for (const string& friendName : adjacencyList[user]) {
-            for (const string& friendOfFriend : adjacencyList[friendName]) {
-                if (friendOfFriend != user && currentFriends.find(friendOfFriend) == currentFriends.end()) {
-                    mutualFriendCount[friendOfFriend]++;
-                }
-            }
-        }
-
-        cout << "\n--- Friend Suggestions for " << user << " ---\n";
-        if (mutualFriendCount.empty()) {
-            cout << "No suggestions available.\n";
-        } else {
-            for (const auto& [suggestedFriend, count] : mutualFriendCount) {
-                cout << suggestedFriend << " (" << count << " mutual friends)\n";
-            }
-        }
-        cout << "---------------------------------\n";
-    }
-
-    // Find the shortest path between two users using BFS
-    void shortestPath(const string& startUser, const string& endUser) {
-        if (adjacencyList.find(startUser) == adjacencyList.end() || adjacencyList.find(endUser) == adjacencyList.end()) {
-            cout << "Both users must exist in the network to find a path.\n";
-            return;
-        }
-
-        queue<string> q;
-        unordered_map<string, string> parent;
-        set<string> visited;
-
-        q.push(startUser);
-        visited.insert(startUser);
-        parent[startUser] = "";
-
-        while (!q.empty()) {
-            string current = q.front();
-            q.pop();
-
-            if (current == endUser) {
-                vector<string> path;
-                for (string at = endUser; at != ""; at = parent[at]) {
-                    path.push_back(at);
-                }
-                reverse(path.begin(), path.end());
-                cout << "\n--- Shortest Path from " << startUser << " to " << endUser << " ---\n";
-                for (const string& user : path) {
-                    cout << user << (user == endUser ? "\n" : " -> ");
-                }
-                return;
-            }
-
-            for (const string& neighbor : adjacencyList[current]) {
-                if (visited.find(neighbor) == visited.end()) {
-                    visited.insert(neighbor);
-                    parent[neighbor] = current;
-                    q.push(neighbor);
-                }
-            }
-        }
-
-        cout << "No path exists between " << startUser << " and " << endUser << ".\n";
-    }
-};
-
-int main() {
-    SocialNetwork sn;
-    int choice;
-    string user1, user2;
-
-    while (true) {
-        cout << "\n--- Social Network Graph Analyzer ---\n";
-        cout << "1. Add User\n";
-        cout << "2. Add Friendship\n";
-        cout << "3. Display Network\n";
-        cout << "4. Suggest Friends\n";
-        cout << "5. Find Shortest Path\n";
-        cout << "6. Exit\n";
-        cout << "Enter your choice: ";
-        cin >> choice;
-
-        switch (choice) {
-            case 1:
-                cout << "Enter username: ";
-                cin >> user1;
-                sn.addUser(user1);
-                break;
-            case 2:
-                cout << "Enter the first user: ";
-                cin >> user1;
-                cout << "Enter the second user: ";
-                cin >> user2;
-                sn.addFriendship(user1, user2);
-                break;
-            case 3:
-                sn.displayNetwork();
-                break;
-            case 4:
-                cout << "Enter username to get friend suggestions: ";
-                cin >> user1;
-                sn.suggestFriends(user1);
-                break;
-            case 5:
-                cout << "Enter the starting user: ";
-                cin >> user1;
-                cout << "Enter the target user: ";
-                cin >> user2;
-                sn.shortestPath(user1, user2);
-                break;
-            case 6:
-                cout << "Exiting the program. Goodbye!\n";
-                return 0;
-            default:
-                cout << "Invalid choice. Please try again.\n";
-        }
-    }
-
-    return 0;
-}
+#include <iostream>
+#include<bits/stdc++.h>
+#include <unordered_map>
+#include <vector>
+#include <queue>
+#include <set>
+#include <string>
+#include <climits>
+#include <iomanip>
+#include "graph_core.hpp"
+#include "graph_paths.hpp"
+#include "graph_suggest.hpp"
+#include "graph_intersect.hpp"
+#include "batch_runner.hpp"
+#include "output_buffer.hpp"
+
+using namespace std;
+
+// Class to represent the social network
+class SocialNetwork {
+private:
+    GraphCore graph; // Graph representation (interned ids + CSR adjacency)
+
+    // Helper function to find mutual friends
+    vector<uint32_t> findMutualFriends(uint32_t user1, uint32_t user2) {
+        return mutualConnections(graph, user1, user2);
+    }
+
+    // Execute one --batch command and write its result line
+    void executeBatchCommand(const vector<string_view>& args, BatchWriter& out) {
+        string_view command = args[0];
+        if (command == "add" && args.size() == 2) {
+            bool added = !graph.contains(args[1]);
+            graph.internUser(args[1]);
+            out.field(command).field(args[1]).field(added ? "ok" : "exists").endLine();
+        } else if (command == "connect" && args.size() == 3) {
+            uint32_t id1 = graph.findUser(args[1]);
+            uint32_t id2 = graph.findUser(args[2]);
+            bool unknown = id1 == GraphCore::npos || id2 == GraphCore::npos;
+            if (unknown || id1 == id2) {
+                out.error(command, unknown ? "unknown user" : "self connection");
+                return;
+            }
+            if (!graph.addEdge(id1, id2)) {
+                out.error(command, "already connected");
+                return;
+            }
+            out.field(command).field(args[1]).field(args[2]).field("ok").endLine();
+        } else if (command == "path" && args.size() == 3) {
+            uint32_t start = graph.findUser(args[1]);
+            uint32_t end = graph.findUser(args[2]);
+            if (start == GraphCore::npos || end == GraphCore::npos) {
+                out.error(command, "unknown user");
+                return;
+            }
+            vector<uint32_t> path = shortestPathBetween(graph, start, end);
+            out.field(command).field(args[1]).field(args[2]).field(static_cast<int64_t>(path.size()) - 1).beginList();
+            for (uint32_t id : path) {
+                out.item(graph.nameOf(id));
+            }
+            out.endLine();
+        } else if (command == "suggest" && (args.size() == 2 || args.size() == 3)) {
+            uint32_t id = graph.findUser(args[1]);
+            size_t k = 10;
+            if (id == GraphCore::npos || (args.size() == 3 && !parseCount(args[2], k))) {
+                out.error(command, id == GraphCore::npos ? "unknown user" : "bad count");
+                return;
+            }
+            vector<Suggestion> suggestions = suggestTopK(graph, id, k);
+            out.field(command).field(args[1]).field(static_cast<int64_t>(suggestions.size())).beginList();
+            for (const Suggestion& suggestion : suggestions) {
+                out.item(graph.nameOf(suggestion.user), suggestion.mutualCount);
+            }
+            out.endLine();
+        } else {
+            out.error(command, "unknown command or wrong number of arguments");
+        }
+    }
+
+public:
+    // Run a command file ("-" for stdin) without the interactive menu
+    size_t runBatch(const string& path) {
+        return runBatchFile(path, [this](const vector<string_view>& args, BatchWriter& out) {
+            executeBatchCommand(args, out);
+        });
+    }
+
+    // Add a new user to the network
+    void addUser(const string& user) {
+        if (graph.contains(user)) {
+            cout << user << " is already in the network.\n";
+        } else {
+            graph.internUser(user);
+            cout << user << " added to the network.\n";
+        }
+    }
+
+    // Add a friendship between two users
+    void addFriendship(const string& user1, const string& user2) {
+        if (user1 == user2) {
+            cout << "A user cannot be friends with themselves.\n";
+            return;
+        }
+
+        uint32_t id1 = graph.findUser(user1);
+        uint32_t id2 = graph.findUser(user2);
+        if (id1 == GraphCore::npos || id2 == GraphCore::npos) {
+            cout << "Both users must exist in the network to establish a friendship.\n";
+            return;
+        }
+
+        if (!graph.addEdge(id1, id2)) {
+            cout << user1 << " and " << user2 << " are already friends.\n";
+            return;
+        }
+        cout << "Friendship established between " << user1 << " and " << user2 << ".\n";
+    }
+
+    // Display the network
+    void displayNetwork() {
+        OutputBuffer &out = standardOutput();
+        out << "\n--- Social Network ---\n";
+        for (uint32_t user = 0; user < graph.userCount(); ++user) {
+            out << graph.nameOf(user) << ": ";
+            for (uint32_t friendId : graph.neighbors(user)) {
+                out << graph.nameOf(friendId) << " ";
+            }
+            out << "\n";
+            out.flushIfFull();
+        }
+        out << "-----------------------\n";
+    }
+
+    // Suggest up to k friends for a user, ranked by mutual friends (k = 0 lists all)
+    void suggestFriends(const string& user, size_t k) {
+        OutputBuffer &out = standardOutput();
+        uint32_t id = graph.findUser(user);
+        if (id == GraphCore::npos) {
+            out << user << " does not exist in the network.\n";
+            return;
+        }
+
+        vector<Suggestion> suggestions = suggestTopK(graph, id, k);
+
+        out << "\n--- Friend Suggestions for " << user << " ---\n";
+        if (suggestions.empty()) {
+            out << "No suggestions available.\n";
+        } else {
+            for (const Suggestion& suggestion : suggestions) {
+                out << graph.nameOf(suggestion.user) << " (" << suggestion.mutualCount << " mutual friends)\n";
+            }
+        }
+        out << "---------------------------------\n";
+    }
+
+    // Find the shortest path between two users using bidirectional BFS
+    void shortestPath(const string& startUser, const string& endUser) {
+        OutputBuffer &out = standardOutput();
+        uint32_t start = graph.findUser(startUser);
+        uint32_t end = graph.findUser(endUser);
+        if (start == GraphCore::npos || end == GraphCore::npos) {
+            out << "Both users must exist in the network to find a path.\n";
+            return;
+        }
+
+        vector<uint32_t> path = shortestPathBetween(graph, start, end);
+        if (!path.empty()) {
+            out << "\n--- Shortest Path from " << startUser << " to " << endUser << " ---\n";
+            for (uint32_t user : path) {
+                out << graph.nameOf(user) << (user == end ? "\n" : " -> ");
+            }
+            return;
+        }
+
+        out << "No path exists between " << startUser << " and " << endUser << ".\n";
+    }
+};
+
+int main(int argc, char* argv[]) {
+    SocialNetwork sn;
+    int choice;
+    size_t limit;
+    string user1, user2;
+
+    if (argc == 3 && string(argv[1]) == "--batch") {
+        sn.runBatch(argv[2]);
+        return 0;
+    }
+
+    while (true) {
+        cout << "\n--- Social Network Graph Analyzer ---\n";
+        cout << "1. Add User\n";
+        cout << "2. Add Friendship\n";
+        cout << "3. Display Network\n";
+        cout << "4. Suggest Friends\n";
+        cout << "5. Find Shortest Path\n";
+        cout << "6. Exit\n";
+        cout << "Enter your choice: ";
+        cin >> choice;
+
+        switch (choice) {
+            case 1:
+                cout << "Enter username: ";
+                cin >> user1;
+                sn.addUser(user1);
+                break;
+            case 2:
+                cout << "Enter the first user: ";
+                cin >> user1;
+                cout << "Enter the second user: ";
+                cin >> user2;
+                sn.addFriendship(user1, user2);
+                break;
+            case 3:
+                sn.displayNetwork();
+                break;
+            case 4:
+                cout << "Enter username to get friend suggestions: ";
+                cin >> user1;
+                cout << "How many suggestions (0 for all): ";
+                cin >> limit;
+                sn.suggestFriends(user1, limit);
+                break;
+            case 5:
+                cout << "Enter the starting user: ";
+                cin >> user1;
+                cout << "Enter the target user: ";
+                cin >> user2;
+                sn.shortestPath(user1, user2);
+                break;
+            case 6:
+                cout << "Exiting the program. Goodbye!\n";
+                return 0;
+            default:
+                cout << "Invalid choice. Please try again.\n";
+        }
+        standardOutput().flush();
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Inverted index for one user attribute (department, role, ...).
+// Each distinct value is interned once and owns a posting list of the user
+// ids that currently hold it, kept sorted so lookups cost O(result size).
+class AttributeIndex {
+public:
+    // Record the value of a newly registered user (ids arrive in order)
+    void addUser(uint32_t user, std::string_view value) {
+        uint32_t valueId = internValue(value);
+        if (userValue.size() <= user) {
+            userValue.resize(user + 1, valueId);
+        }
+        userValue[user] = valueId;
+        insertSorted(postings[valueId], user);
+    }
+
+    // Change the value of an existing user and move it between posting lists
+    void set(uint32_t user, std::string_view value) {
+        uint32_t valueId = internValue(value);
+        uint32_t oldValue = userValue[user];
+        if (oldValue == valueId) {
+            return;
+        }
+        std::vector<uint32_t> &oldList = postings[oldValue];
+        oldList.erase(std::lower_bound(oldList.begin(), oldList.end(), user));
+        insertSorted(postings[valueId], user);
+        userValue[user] = valueId;
+    }
+
+    const std::string &valueOf(uint32_t user) const { return values[userValue[user]]; }
+
+    // Sorted ids of every user holding `value`
+    const std::vector<uint32_t> &usersWith(std::string_view value) const {
+        static const std::vector<uint32_t> empty;
+        auto it = valueIds.find(value);
+        return it == valueIds.end() ? empty : postings[it->second];
+    }
+
+    // Raw tables for serialisation
+    uint32_t valueCount() const { return static_cast<uint32_t>(values.size()); }
+    const std::string &valueName(uint32_t valueId) const { return values[valueId]; }
+    const std::vector<uint32_t> &userValueIds() const { return userValue; }
+
+    // Rebuild from a value table and one value id per user (ids 0..users-1)
+    void assign(const std::vector<std::string_view> &valueTable, const uint32_t *valueIdOf, size_t users) {
+        values.clear();
+        valueIds.clear();
+        postings.clear();
+        for (std::string_view value : valueTable) {
+            internValue(value);
+        }
+        userValue.assign(valueIdOf, valueIdOf + users);
+        for (uint32_t user = 0; user < users; ++user) {
+            postings[userValue[user]].push_back(user);
+        }
+    }
+
+private:
+    std::deque<std::string> values;                          // value id -> text
+    std::unordered_map<std::string_view, uint32_t> valueIds; // text -> value id
+    std::vector<uint32_t> userValue;                         // user id -> value id
+    std::vector<std::vector<uint32_t>> postings;             // value id -> sorted user ids
+
+    uint32_t internValue(std::string_view value) {
+        auto it = valueIds.find(value);
+        if (it != valueIds.end()) {
+            return it->second;
+        }
+        uint32_t valueId = static_cast<uint32_t>(values.size());
+        values.emplace_back(value);
+        valueIds.emplace(values.back(), valueId);
+        postings.emplace_back();
+        return valueId;
+    }
+
+    static void insertSorted(std::vector<uint32_t> &list, uint32_t user) {
+        if (list.empty() || list.back() < user) {
+            list.push_back(user);
+        } else {
+            list.insert(std::lower_bound(list.begin(), list.end(), user), user);
+        }
+    }
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "output_buffer.hpp"
+
+// Non-interactive command processing for `--batch FILE` ("-" reads stdin).
+//
+// Every input line is one command ("path alice bob", "suggest alice 10", ...);
+// blank lines and lines starting with '#' are ignored. Every command produces
+// exactly one tab-separated output line that starts with the command name,
+// or with "error" if it could not be executed. Lists are comma-separated.
+
+// Formats result lines into an OutputBuffer
+class BatchWriter {
+public:
+    explicit BatchWriter(OutputBuffer &out) : out(out) {}
+    ~BatchWriter() { flush(); }
+
+    BatchWriter &field(std::string_view text) {
+        separate('\t');
+        out << text;
+        return *this;
+    }
+
+    BatchWriter &field(int64_t value) {
+        separate('\t');
+        out << value;
+        return *this;
+    }
+
+    // Start a comma-separated list field; fill it with item()
+    BatchWriter &beginList() {
+        separate('\t');
+        listEmpty = true;
+        return *this;
+    }
+
+    BatchWriter &item(std::string_view text) {
+        if (!listEmpty) {
+            out << ',';
+        }
+        listEmpty = false;
+        out << text;
+        return *this;
+    }
+
+    // "text:count" list entry
+    BatchWriter &item(std::string_view text, int64_t count) {
+        item(text);
+        out << ':' << count;
+        return *this;
+    }
+
+    void endLine() {
+        out << '\n';
+        lineStart = true;
+        out.flushIfFull();
+    }
+
+    // Position in the output; before endLine(), since(mark()) taken at the
+    // start of a line is the text of that line so far (the buffer is only
+    // drained at line ends)
+    size_t mark() const { return out.size(); }
+
+    std::string_view since(size_t position) const { return out.text().substr(position); }
+
+    // Append complete, already formatted lines (e.g. a cached result)
+    void lines(std::string_view text) {
+        out.write(text);
+        lineStart = true;
+    }
+
+    // Convenience for "error <command> <message>"
+    void error(std::string_view command, std::string_view message) {
+        field("error").field(command).field(message).endLine();
+    }
+
+    void flush() { out.flush(); }
+
+private:
+    OutputBuffer &out;
+    bool lineStart = true;
+    bool listEmpty = true;
+
+    void separate(char separator) {
+        if (!lineStart) {
+            out << separator;
+        }
+        lineStart = false;
+    }
+};
+
+// Parse an unsigned count argument; false if it is not a number
+inline bool parseCount(std::string_view text, size_t &value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+using BatchCommand = std::function<void(const std::vector<std::string_view> &args, BatchWriter &out)>;
+
+// Feed every command in `path` to `execute`, writing results to stdout.
+// Returns the number of commands run; a summary goes to stderr.
+inline size_t runBatchFile(const std::string &path, const BatchCommand &execute) {
+    FILE *in = path == "-" ? stdin : fopen(path.c_str(), "rb");
+    if (in == nullptr) {
+        fprintf(stderr, "Unable to open batch file %s\n", path.c_str());
+        return 0;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    BatchWriter out(standardOutput());
+    std::vector<std::string_view> args;
+    std::string block;   // unprocessed input, always starts at a line
+    std::vector<char> chunk(1 << 20);
+    size_t commands = 0;
+    bool done = false;
+    while (!done) {
+        size_t n = fread(chunk.data(), 1, chunk.size(), in);
+        done = n == 0;
+        block.append(chunk.data(), n);
+        if (done && !block.empty() && block.back() != '\n') {
+            block += '\n';
+        }
+
+        size_t pos = 0, end;
+        while ((end = block.find('\n', pos)) != std::string::npos) {
+            std::string_view line(block.data() + pos, end - pos);
+            pos = end + 1;
+
+            args.clear();
+            size_t i = 0;
+            while (i < line.size()) {
+                while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) {
+                    ++i;
+                }
+                size_t start = i;
+                while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') {
+                    ++i;
+                }
+                if (i > start) {
+                    args.push_back(line.substr(start, i - start));
+                }
+            }
+            if (args.empty() || args[0][0] == '#') {
+                continue;
+            }
+            execute(args, out);
+            ++commands;
+        }
+        block.erase(0, pos);
+    }
+    out.flush();
+    if (in != stdin) {
+        fclose(in);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    fprintf(stderr, "Processed %zu commands in %.3fs (%.0f commands/s)\n", commands, seconds,
+            seconds > 0 ? commands / seconds : 0.0);
+    return commands;
+}
@@ -0,0 +1,476 @@
+// Microbenchmarks for the network engine on synthetic graphs.
+//
+// Build: g++ -std=c++17 -O2 -pthread benchmark.cpp -o benchmark
+// Usage: benchmark [--model er|ba|dept] [--users N] [--degree D] [--departments K]
+//                  [--queries Q] [--seed S] [--json FILE] [--dir DIR] [--help]
+//
+// Every operation the menu programs expose is timed on the same data
+// structures they use (GraphCore, AttributeIndex, snapshot, write-ahead log,
+// bulk ingest). Per-operation latencies are reported as percentiles; the full
+// result set is written as JSON so runs can be compared across versions.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "graph_core.hpp"
+#include "graph_paths.hpp"
+#include "graph_suggest.hpp"
+#include "graph_intersect.hpp"
+#include "graph_neighborhood.hpp"
+#include "graph_distances.hpp"
+#include "graph_generators.hpp"
+#include "attribute_index.hpp"
+#include "snapshot.hpp"
+#include "write_ahead_log.hpp"
+#include "bulk_ingest.hpp"
+#include "suggestion_table.hpp"
+#include "landmark_index.hpp"
+#include "network_report.hpp"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+struct BenchmarkOptions {
+    GeneratorOptions generator;
+    size_t queries = 2000;
+    string jsonPath = "benchmark.json";
+    string workDir = ".";
+};
+
+// Timing summary of one operation
+struct BenchmarkResult {
+    string name;
+    size_t operations = 0;
+    double seconds = 0;
+    vector<double> latencies; // microseconds per operation (empty for one-shot runs)
+    size_t items = 0;         // elements processed (edges, users, ...) for one-shot runs
+
+    double percentile(double p) const {
+        if (latencies.empty()) {
+            return 0;
+        }
+        size_t rank = min(latencies.size() - 1, static_cast<size_t>(p / 100.0 * latencies.size()));
+        return latencies[rank];
+    }
+};
+
+// The graph and attribute indexes of the extended NetworkManager
+struct BenchmarkNetwork {
+    GraphCore graph;
+    AttributeIndex departments, roles, interests, games, aims;
+
+    SnapshotAttributes attributeTables() const {
+        return {{"department", &departments}, {"role", &roles}, {"interest", &interests},
+                {"game", &games}, {"aim", &aims}};
+    }
+
+    SnapshotAttributeTargets attributeTargets() {
+        return {{"department", &departments}, {"role", &roles}, {"interest", &interests},
+                {"game", &games}, {"aim", &aims}};
+    }
+
+    void addUser(uint32_t id, string_view department, string_view role, string_view interest, string_view game,
+                 string_view aim) {
+        departments.addUser(id, department);
+        roles.addUser(id, role);
+        interests.addUser(id, interest);
+        games.addUser(id, game);
+        aims.addUser(id, aim);
+    }
+};
+
+static double secondsSince(Clock::time_point start) {
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Peak resident set size of this process in KiB
+static long peakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Time `operation(i)` for i in [0, count) individually
+static BenchmarkResult measureEach(const string &name, size_t count, const function<void(size_t)> &operation) {
+    BenchmarkResult result;
+    result.name = name;
+    result.operations = count;
+    result.latencies.reserve(count);
+    auto started = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        auto opStart = Clock::now();
+        operation(i);
+        result.latencies.push_back(chrono::duration<double, micro>(Clock::now() - opStart).count());
+    }
+    result.seconds = secondsSince(started);
+    sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+// Time one bulk operation that processes `items` elements
+static BenchmarkResult measureOnce(const string &name, const function<size_t()> &operation) {
+    BenchmarkResult result;
+    result.name = name;
+    result.operations = 1;
+    auto started = Clock::now();
+    result.items = operation();
+    result.seconds = secondsSince(started);
+    return result;
+}
+
+static void printResult(const BenchmarkResult &result) {
+    if (result.latencies.empty()) {
+        printf("%-22s %10.3f s  %14.0f items/s\n", result.name.c_str(), result.seconds,
+               result.seconds > 0 ? result.items / result.seconds : 0.0);
+    } else {
+        printf("%-22s %10.0f ops/s  p50 %9.2f us  p90 %9.2f us  p99 %9.2f us  max %9.2f us\n", result.name.c_str(),
+               result.seconds > 0 ? result.operations / result.seconds : 0.0, result.percentile(50),
+               result.percentile(90), result.percentile(99), result.latencies.back());
+    }
+}
+
+static bool writeJson(const string &path, const BenchmarkOptions &options, const SyntheticNetwork &net,
+                      const vector<BenchmarkResult> &results) {
+    ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+    const GeneratorOptions &gen = options.generator;
+    out << "{\n  \"config\": {\"model\": \"" << graphModelName(gen.model) << "\", \"users\": " << gen.userCount
+        << ", \"averageDegree\": " << gen.averageDegree << ", \"departments\": " << gen.departmentCount
+        << ", \"edges\": " << net.edges.size() << ", \"queries\": " << options.queries << ", \"seed\": " << gen.seed
+        << ", \"threads\": " << ingestThreads() << "},\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult &r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"operations\": " << r.operations << ", \"seconds\": " << r.seconds;
+        if (r.latencies.empty()) {
+            out << ", \"items\": " << r.items << ", \"itemsPerSecond\": " << (r.seconds > 0 ? r.items / r.seconds : 0);
+        } else {
+            out << ", \"opsPerSecond\": " << (r.seconds > 0 ? r.operations / r.seconds : 0)
+                << ", \"latencyUs\": {\"p50\": " << r.percentile(50) << ", \"p90\": " << r.percentile(90)
+                << ", \"p99\": " << r.percentile(99) << ", \"max\": " << r.latencies.back() << "}";
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n  \"peakRssKb\": " << peakRssKb() << "\n}\n";
+    return out.good();
+}
+
+// List the flags with their defaults, and the graph models --model accepts
+static void printUsage(ostream &out) {
+    const BenchmarkOptions defaults;
+    const GeneratorOptions &gen = defaults.generator;
+    out << "Usage: benchmark [options]\n"
+        << "  --model MODEL      graph generator (default er):\n"
+        << "                       er    Erdos-Renyi, uniform random pairs\n"
+        << "                       ba    Barabasi-Albert, preferential attachment with hub users\n"
+        << "                       dept  department groups, most connections inside a department\n"
+        << "  --users N          users to generate (default " << gen.userCount << ")\n"
+        << "  --degree D         average connections per user (default " << gen.averageDegree << ")\n"
+        << "  --departments K    departments to spread users over (default " << gen.departmentCount << ")\n"
+        << "  --queries Q        timed calls per query benchmark (default " << defaults.queries << ")\n"
+        << "  --seed S           random seed (default " << gen.seed << ")\n"
+        << "  --json FILE        where to write the results (default " << defaults.jsonPath << ")\n"
+        << "  --dir DIR          directory for the generated data files (default " << defaults.workDir << ")\n"
+        << "  --help             show this message\n";
+}
+
+// False (after printing why) if the arguments are invalid;
+// --help prints the usage and exits
+static bool parseArguments(int argc, char *argv[], BenchmarkOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        string flag = argv[i];
+        if (flag == "--help" || flag == "-h") {
+            printUsage(cout);
+            exit(0);
+        }
+        bool known = flag == "--model" || flag == "--users" || flag == "--degree" || flag == "--departments" ||
+                     flag == "--queries" || flag == "--seed" || flag == "--json" || flag == "--dir";
+        if (!known) {
+            cerr << "Unknown option " << flag << "\n";
+            printUsage(cerr);
+            return false;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << flag << "\n";
+            printUsage(cerr);
+            return false;
+        }
+        string value = argv[++i];
+        try {
+            if (flag == "--model") {
+                if (!parseGraphModel(value, options.generator.model)) {
+                    cerr << "Unknown model " << value << " (use er, ba or dept)\n";
+                    return false;
+                }
+            } else if (flag == "--users") {
+                options.generator.userCount = static_cast<uint32_t>(stoul(value));
+            } else if (flag == "--degree") {
+                options.generator.averageDegree = static_cast<uint32_t>(stoul(value));
+            } else if (flag == "--departments") {
+                options.generator.departmentCount = static_cast<uint32_t>(stoul(value));
+            } else if (flag == "--queries") {
+                options.queries = stoul(value);
+            } else if (flag == "--seed") {
+                options.generator.seed = stoull(value);
+            } else if (flag == "--json") {
+                options.jsonPath = value;
+            } else {
+                options.workDir = value;
+            }
+        } catch (const logic_error &) { // stoul: not a number, or out of range
+            cerr << "Invalid value " << value << " for " << flag << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    BenchmarkOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+    const GeneratorOptions &gen = options.generator;
+    string base = options.workDir + "/benchmark_data";
+    string userFile = base + ".users", edgeFile = base + ".edges", snapshotFile = base + ".snap",
+           logFile = base + ".wal", dotFile = base + ".dot", suggestionFile = base + ".sugg",
+           landmarkFile = base + ".lmk";
+
+    printf("Generating %s graph: %u users, average degree %u...\n", graphModelName(gen.model), gen.userCount,
+           gen.averageDegree);
+    SyntheticNetwork net = generateNetwork(gen);
+    {
+        ofstream users(userFile), edges(edgeFile);
+        for (size_t u = 0; u < net.names.size(); ++u) {
+            users << net.names[u] << ' ' << net.departments[u] << ' ' << net.roles[u] << ' ' << net.interests[u]
+                  << ' ' << net.games[u] << ' ' << net.aims[u] << '\n';
+        }
+        for (const auto &[u, v] : net.edges) {
+            edges << net.names[u] << ' ' << net.names[v] << '\n';
+        }
+    }
+
+    vector<BenchmarkResult> results;
+    BenchmarkNetwork network;
+    results.push_back(measureOnce("build_in_memory", [&] {
+        for (size_t u = 0; u < net.names.size(); ++u) {
+            uint32_t id = network.graph.internUser(net.names[u]);
+            network.addUser(id, net.departments[u], net.roles[u], net.interests[u], net.games[u], net.aims[u]);
+        }
+        network.graph.addEdges(net.edges);
+        return net.edges.size();
+    }));
+
+    results.push_back(measureOnce("text_import", [&] {
+        BenchmarkNetwork imported;
+        ingestUsers<6>(userFile, [&](const array<string_view, 6> &f) {
+            uint32_t id = imported.graph.internUser(f[0]);
+            imported.addUser(id, f[1], f[2], f[3], f[4], f[5]);
+        });
+        IngestStats stats;
+        ingestEdges(edgeFile, imported.graph, [&](uint32_t id) { imported.addUser(id, "", "", "", "", ""); }, &stats);
+        return stats.edges;
+    }));
+
+    results.push_back(measureOnce("snapshot_save", [&] {
+        saveSnapshot(snapshotFile, network.graph, network.attributeTables());
+        return network.graph.connectionCount();
+    }));
+
+    results.push_back(measureOnce("snapshot_load", [&] {
+        BenchmarkNetwork loaded;
+        loadSnapshot(snapshotFile, loaded.graph, loaded.attributeTargets());
+        return loaded.graph.connectionCount();
+    }));
+
+    mt19937_64 rng(gen.seed + 1);
+    uint32_t n = network.graph.userCount();
+    auto randomUser = [&] { return static_cast<uint32_t>(rng() % n); };
+    vector<pair<uint32_t, uint32_t>> pairs(options.queries);
+    for (auto &p : pairs) {
+        p = {randomUser(), randomUser()};
+    }
+
+    // Same sequence as NetworkManager::addConnection: membership check, insert, log append
+    {
+        remove(logFile.c_str());
+        WriteAheadLog log;
+        log.open(logFile, 0, 0);
+        results.push_back(measureEach("add_connection", pairs.size(), [&](size_t i) {
+            auto [u, v] = pairs[i];
+            if (network.graph.addEdge(u, v)) {
+                log.append(LogAddConnection, {network.graph.nameOf(u), network.graph.nameOf(v)});
+            }
+        }));
+        log.close();
+    }
+
+    string sink; // query output is formatted as the menu would, then discarded
+
+    // Interleaved writes and reads, as in a --batch session: every connect is
+    // followed by a path or suggestion query that has to see it
+    {
+        vector<pair<uint32_t, uint32_t>> mixedPairs(pairs.size());
+        for (auto &p : mixedPairs) {
+            p = {randomUser(), randomUser()};
+        }
+        WriteAheadLog log;
+        log.open(logFile, 0, 0);
+        results.push_back(measureEach("connect_then_query", mixedPairs.size(), [&](size_t i) {
+            auto [u, v] = mixedPairs[i];
+            if (network.graph.addEdge(u, v)) {
+                log.append(LogAddConnection, {network.graph.nameOf(u), network.graph.nameOf(v)});
+            }
+            sink.clear();
+            if (i % 2 == 0) {
+                for (uint32_t user : shortestPathBetween(network.graph, u, randomUser())) {
+                    sink += network.graph.nameOf(user);
+                }
+            } else {
+                for (const Suggestion &s : suggestTopK(network.graph, v, 10)) {
+                    sink += network.graph.nameOf(s.user);
+                    sink += to_string(s.mutualCount);
+                }
+            }
+        }));
+        log.close();
+    }
+    network.graph.compact();
+
+    results.push_back(measureEach("suggest_connections", pairs.size(), [&](size_t i) {
+        sink.clear();
+        for (const Suggestion &s : suggestTopK(network.graph, pairs[i].first, 10)) {
+            sink += network.graph.nameOf(s.user);
+            sink += to_string(s.mutualCount);
+        }
+    }));
+
+    results.push_back(measureOnce("precompute_suggestions", [&] {
+        buildSuggestionTable(suggestionFile, network.graph, 10, 0);
+        return static_cast<size_t>(n);
+    }));
+
+    results.push_back(measureEach("shortest_path", pairs.size(), [&](size_t i) {
+        sink.clear();
+        for (uint32_t user : shortestPathBetween(network.graph, pairs[i].first, pairs[i].second)) {
+            sink += network.graph.nameOf(user);
+        }
+    }));
+
+    // Landmark estimates (bounds plus a candidate path) against the exact
+    // search, on pairs that add_connection did not just join
+    results.push_back(measureOnce("build_landmarks", [&] {
+        buildLandmarkIndex(landmarkFile, network.graph, 16, LandmarkSelection::Degree, 0);
+        return static_cast<size_t>(n);
+    }));
+    {
+        LandmarkIndex landmarks;
+        landmarks.open(landmarkFile);
+        vector<pair<uint32_t, uint32_t>> farPairs(pairs.size());
+        for (auto &p : farPairs) {
+            p = {randomUser(), randomUser()};
+        }
+        results.push_back(measureEach("exact_path", farPairs.size(), [&](size_t i) {
+            sink.clear();
+            for (uint32_t user : shortestPathBetween(network.graph, farPairs[i].first, farPairs[i].second)) {
+                sink += network.graph.nameOf(user);
+            }
+        }));
+        results.push_back(measureEach("estimate_path", farPairs.size(), [&](size_t i) {
+            auto [u, v] = farPairs[i];
+            sink.clear();
+            for (uint32_t user : landmarks.pathThrough(network.graph, u, v, landmarks.estimate(u, v))) {
+                sink += network.graph.nameOf(user);
+            }
+        }));
+    }
+
+    for (uint32_t hops : {2u, 3u}) {
+        results.push_back(measureEach("k_hop_" + to_string(hops), pairs.size(), [&](size_t i) {
+            sink = to_string(kHopNeighborhood(network.graph, pairs[i].first, hops, false).total());
+        }));
+    }
+
+    // Whole-graph BFS on one thread and on the shared pool
+    {
+        size_t sources = min<size_t>(pairs.size(), 10);
+        ThreadPool single(1);
+        ParallelBfs sequential(single), parallel;
+        BenchmarkResult one = measureEach("distances_from_1t", sources, [&](size_t i) {
+            sequential.run(network.graph, pairs[i].first);
+        });
+        BenchmarkResult all = measureEach("distances_from", sources, [&](size_t i) {
+            parallel.run(network.graph, pairs[i].first);
+        });
+        printf("distances_from: %.2fx speedup on %u threads\n", all.seconds > 0 ? one.seconds / all.seconds : 0.0,
+               ThreadPool::shared().size());
+        results.push_back(one);
+        results.push_back(all);
+    }
+
+    results.push_back(measureEach("mutual_connections", pairs.size(), [&](size_t i) {
+        sink.clear();
+        for (uint32_t user : mutualConnections(network.graph, pairs[i].first, pairs[i].second)) {
+            sink += network.graph.nameOf(user);
+        }
+    }));
+
+    // The menu printers and exporter themselves, formatting into a buffer
+    // that is discarded (listings) or written to a file (DOT)
+    struct Listing {
+        const char *name;
+        const char *title;
+        const AttributeIndex *index;
+        const AttributeIndex *detail;
+    };
+    OutputBuffer listingText;
+    for (const Listing &listing :
+         {Listing{"list_by_department", "Users in Department: ", &network.departments, &network.roles},
+          Listing{"list_by_role", "Users with Role: ", &network.roles, &network.departments},
+          Listing{"list_by_interest", "Users Interested in ", &network.interests, &network.roles},
+          Listing{"list_by_game", "Users who like ", &network.games, &network.roles},
+          Listing{"list_by_aim", "Users who want to be a ", &network.aims, &network.roles}}) {
+        results.push_back(measureEach(listing.name, pairs.size(), [&](size_t i) {
+            listingText.clear();
+            const string &value = listing.index->valueOf(pairs[i].first);
+            writeUserListing(listingText, listing.title + value, listing.index->usersWith(value), network.graph,
+                             *listing.detail, "No users found.");
+        }));
+    }
+
+    results.push_back(measureOnce("dot_export", [&] {
+        OutputBuffer dot;
+        if (dot.open(dotFile)) {
+            writeDotGraph(dot, GraphView(network.graph));
+            dot.close();
+        }
+        return network.graph.connectionCount();
+    }));
+
+    for (const BenchmarkResult &result : results) {
+        printResult(result);
+    }
+    printf("peak RSS %ld KiB\n", peakRssKb());
+
+    for (const string &file : {userFile, edgeFile, snapshotFile, logFile, dotFile, suggestionFile, landmarkFile}) {
+        remove(file.c_str());
+    }
+    if (!writeJson(options.jsonPath, options, net, results)) {
+        cerr << "Unable to write " << options.jsonPath << "\n";
+        return 1;
+    }
+    printf("Results written to %s\n", options.jsonPath.c_str());
+    return 0;
+}
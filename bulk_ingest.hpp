@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "graph_core.hpp"
+#include "mapped_file.hpp"
+
+// Parallel loaders for large user and edge-list text files.
+// Files are memory-mapped and cut into line-aligned chunks, one per thread;
+// tokens are string_views into the mapping, so nothing is copied until a
+// name is actually interned.
+
+struct IngestStats {
+    size_t users = 0;    // user records read
+    size_t edges = 0;    // connections added (duplicates of existing ones are not counted)
+    size_t newUsers = 0; // users created for names only seen in the edge list
+    double seconds = 0;
+
+    double edgesPerSecond() const { return seconds > 0 ? edges / seconds : 0; }
+};
+
+inline unsigned ingestThreads() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+// Split text into at most `parts` pieces that end on line boundaries
+inline std::vector<std::string_view> splitLines(std::string_view text, unsigned parts) {
+    std::vector<std::string_view> chunks;
+    size_t start = 0;
+    for (unsigned i = 1; i <= parts && start < text.size(); ++i) {
+        size_t end = i == parts ? text.size() : std::max(start, text.size() * i / parts);
+        end = text.find('\n', end);
+        end = end == std::string_view::npos ? text.size() : end + 1;
+        chunks.push_back(text.substr(start, end - start));
+        start = end;
+    }
+    return chunks;
+}
+
+// Split one line into whitespace-separated tokens (up to N); returns the count
+template <size_t N>
+size_t tokenize(std::string_view line, std::array<std::string_view, N> &tokens) {
+    size_t count = 0, pos = 0;
+    while (count < N) {
+        pos = line.find_first_not_of(" \t\r", pos);
+        if (pos == std::string_view::npos) {
+            break;
+        }
+        size_t end = line.find_first_of(" \t\r", pos);
+        end = end == std::string_view::npos ? line.size() : end;
+        tokens[count++] = line.substr(pos, end - pos);
+        pos = end;
+    }
+    return count;
+}
+
+// Call `onLine` for every non-empty, non-comment line of a chunk
+template <typename OnLine>
+void forEachLine(std::string_view chunk, OnLine onLine) {
+    size_t pos = 0;
+    while (pos < chunk.size()) {
+        size_t end = chunk.find('\n', pos);
+        end = end == std::string_view::npos ? chunk.size() : end;
+        std::string_view line = chunk.substr(pos, end - pos);
+        if (!line.empty() && line[0] != '#') {
+            onLine(line);
+        }
+        pos = end + 1;
+    }
+}
+
+// Run work(chunkIndex) on one thread per chunk
+inline void runChunks(size_t chunkCount, const std::function<void(size_t)> &work) {
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        workers.emplace_back(work, i);
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+// Read a user file ("username field field ..." per line) in parallel and
+// hand each record to `insert` in file order. Records have N fields.
+// Returns false, inserting nothing, if the file cannot be read.
+template <size_t N>
+bool ingestUsers(const std::string &path, const std::function<void(const std::array<std::string_view, N> &)> &insert,
+                 size_t *count = nullptr) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        return false;
+    }
+    file.adviseSequential();
+    std::vector<std::string_view> chunks = splitLines(file.text(), ingestThreads());
+    std::vector<std::vector<std::array<std::string_view, N>>> parsed(chunks.size());
+    runChunks(chunks.size(), [&](size_t i) {
+        forEachLine(chunks[i], [&](std::string_view line) {
+            std::array<std::string_view, N> fields;
+            if (tokenize(line, fields) > 0) {
+                parsed[i].push_back(fields);
+            }
+        });
+    });
+
+    size_t inserted = 0;
+    for (const auto &records : parsed) {
+        for (const auto &record : records) {
+            insert(record);
+            ++inserted;
+        }
+    }
+    if (count != nullptr) {
+        *count = inserted;
+    }
+    return true;
+}
+
+// Thread-safe name -> id assignment for names missing from the graph.
+// Existing names are resolved with lock-free reads of the (frozen) graph;
+// new names go through one of several locked shards and draw ids from a
+// shared counter, so they stay dense after the graph's current users.
+class ConcurrentInterner {
+public:
+    explicit ConcurrentInterner(const GraphCore &graph) : graph(graph), nextId(graph.userCount()) {}
+
+    uint32_t idOf(std::string_view name) {
+        uint32_t id = graph.findUser(name);
+        if (id != GraphCore::npos) {
+            return id;
+        }
+        Shard &shard = shards[std::hash<std::string_view>()(name) % shardCount];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto [it, inserted] = shard.ids.try_emplace(name, 0);
+        if (inserted) {
+            it->second = nextId.fetch_add(1);
+            shard.added.emplace_back(it->second, name);
+        }
+        return it->second;
+    }
+
+    // Names that were not in the graph, ordered by their assigned id
+    std::vector<std::string_view> newNames() const {
+        std::vector<std::string_view> names(nextId - graph.userCount());
+        for (const Shard &shard : shards) {
+            for (const auto &[id, name] : shard.added) {
+                names[id - graph.userCount()] = name;
+            }
+        }
+        return names;
+    }
+
+private:
+    static constexpr size_t shardCount = 64;
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, uint32_t> ids;
+        std::vector<std::pair<uint32_t, std::string_view>> added;
+    };
+
+    const GraphCore &graph;
+    std::atomic<uint32_t> nextId;
+    std::array<Shard, shardCount> shards;
+};
+
+// Read an edge list ("user1 user2" per line) in parallel and add every edge
+// with a single CSR merge. Names not yet in the graph are interned and
+// reported through `onNewUser(id)` so the caller can give them attributes.
+// Self-loops are skipped. Returns false, changing nothing, if the file
+// cannot be read.
+inline bool ingestEdges(const std::string &path, GraphCore &graph, const std::function<void(uint32_t)> &onNewUser,
+                        IngestStats *stats = nullptr) {
+    auto started = std::chrono::steady_clock::now();
+    IngestStats result;
+
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        return false;
+    }
+    file.adviseSequential();
+    std::vector<std::string_view> chunks = splitLines(file.text(), ingestThreads());
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> parts(chunks.size());
+    ConcurrentInterner interner(graph);
+    runChunks(chunks.size(), [&](size_t i) {
+        forEachLine(chunks[i], [&](std::string_view line) {
+            std::array<std::string_view, 2> ends;
+            if (tokenize(line, ends) == 2 && ends[0] != ends[1]) {
+                parts[i].emplace_back(interner.idOf(ends[0]), interner.idOf(ends[1]));
+            }
+        });
+    });
+
+    for (std::string_view name : interner.newNames()) {
+        uint32_t id = graph.internUser(name);
+        onNewUser(id);
+        ++result.newUsers;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    size_t total = 0;
+    for (const auto &part : parts) {
+        total += part.size();
+    }
+    edges.reserve(total);
+    for (auto &part : parts) {
+        edges.insert(edges.end(), part.begin(), part.end());
+        std::vector<std::pair<uint32_t, uint32_t>>().swap(part);
+    }
+    size_t before = graph.connectionCount();
+    graph.addEdges(edges);
+
+    // Raw lines overcount: repeated lines, both directions of one pair and
+    // connections that already existed all collapse in the merge
+    result.edges = graph.connectionCount() - before;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    if (stats != nullptr) {
+        *stats = result;
+    }
+    return true;
+}
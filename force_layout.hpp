@@ -0,0 +1,406 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "graph_view.hpp"
+#include "mapped_file.hpp"
+#include "thread_pool.hpp"
+
+// Force-directed layout for the network visualizer.
+//
+// Connected users attract each other (d^2 / k along the connection), every
+// pair of users repels (k^2 / d) and a weak gravity keeps components from
+// drifting apart; each step moves a user along its net force by at most the
+// current temperature, which cools towards zero (Fruchterman-Reingold).
+// Repulsion between all pairs is approximated with a Barnes-Hut quadtree:
+// a cell that looks smaller than `theta` times its distance, and does not
+// contain the user, acts as one body at its centre of mass, so a step costs
+// O(n log n) instead of O(n^2). The tree is built once per step and then
+// only read, so forces are accumulated in parallel on the pool, one chunk of
+// users per worker.
+//
+// extend() updates a previous layout after the network grew: new users start
+// at the centroid of their placed neighbours, and only users that are new or
+// gained connections are relaxed, at a low temperature, against a tree of
+// everyone else that is built only once.
+struct LayoutPoint {
+    float x = 0, y = 0;
+};
+
+struct LayoutOptions {
+    float idealLength = 80;  // preferred length of a connection
+    float theta = 1.2f;      // Barnes-Hut opening criterion
+    float gravity = 1.0f;    // pull towards the centre per unit of distance from it
+    size_t iterations = 0;   // steps of a full layout; 0 chooses from the user count
+    size_t relaxSteps = 40;  // steps of an incremental update
+};
+
+struct LayoutStats {
+    size_t users = 0;
+    size_t moved = 0; // users the simulation moved (all of them unless incremental)
+    size_t iterations = 0;
+    double seconds = 0;
+    unsigned threads = 0;
+    bool incremental = false;
+};
+
+// Barnes-Hut quadtree over a set of users. Every cell keeps its users
+// contiguous in `order`, so a leaf is a short run of bodies.
+class LayoutQuadTree {
+public:
+    void build(const std::vector<LayoutPoint> &positions, const std::vector<uint32_t> &users) {
+        cells.clear();
+        order = users;
+        if (order.empty()) {
+            return;
+        }
+        float left = positions[order[0]].x, right = left, top = positions[order[0]].y, bottom = top;
+        for (uint32_t user : order) {
+            left = std::min(left, positions[user].x);
+            right = std::max(right, positions[user].x);
+            top = std::min(top, positions[user].y);
+            bottom = std::max(bottom, positions[user].y);
+        }
+        float size = std::max({right - left, bottom - top, 1.0f});
+        buildCell(positions, 0, static_cast<uint32_t>(order.size()), left, top, size, 0);
+    }
+
+    // Add the repulsion of every user in the tree except `self` on a user at `p`
+    void repel(const std::vector<LayoutPoint> &positions, uint32_t self, LayoutPoint p, float theta,
+               float strength, float &fx, float &fy) const {
+        if (cells.empty()) {
+            return;
+        }
+        float theta2 = theta * theta;
+        std::array<uint32_t, 4 * maxDepth + 4> stack;
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Cell &cell = cells[stack[--top]];
+            float dx = p.x - cell.x, dy = p.y - cell.y;
+            float d2 = dx * dx + dy * dy;
+            if (cell.leaf()) {
+                for (uint32_t i = cell.first; i < cell.first + cell.count; ++i) {
+                    uint32_t other = order[i];
+                    if (other != self) {
+                        addRepulsion(p, positions[other], self, other, strength, fx, fy);
+                    }
+                }
+            } else if (cell.size * cell.size < theta2 * d2 && !cell.contains(p)) {
+                fx += dx * strength * cell.count / d2;
+                fy += dy * strength * cell.count / d2;
+            } else {
+                for (uint32_t child : cell.children) {
+                    if (child != none) {
+                        stack[top++] = child;
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t none = UINT32_MAX;
+    static constexpr uint32_t leafSize = 8;
+    static constexpr int maxDepth = 24;
+
+    struct Cell {
+        float x, y;      // centre of mass
+        float left, top; // corner of the square
+        float size;      // side of the square
+        uint32_t first, count;
+        uint32_t children[4];
+
+        // A cell holding `p` would push it with part of its own mass, so it
+        // is never approximated for it
+        bool contains(LayoutPoint p) const {
+            return p.x >= left && p.x <= left + size && p.y >= top && p.y <= top + size;
+        }
+
+        bool leaf() const {
+            return children[0] == none && children[1] == none && children[2] == none && children[3] == none;
+        }
+    };
+
+    std::vector<Cell> cells;
+    std::vector<uint32_t> order;
+
+    // Push `p` away from `q`; coincident users are separated in a direction
+    // derived from their ids so the result stays deterministic
+    static void addRepulsion(LayoutPoint p, LayoutPoint q, uint32_t self, uint32_t other, float strength,
+                             float &fx, float &fy) {
+        float dx = p.x - q.x, dy = p.y - q.y;
+        float d2 = dx * dx + dy * dy;
+        if (d2 < 1e-4f) {
+            float angle = float(self * 2654435761u % 6283) / 1000 - float(other % 7);
+            dx = std::cos(angle) * 0.01f;
+            dy = std::sin(angle) * 0.01f;
+            d2 = 1e-4f;
+        }
+        fx += dx * strength / d2;
+        fy += dy * strength / d2;
+    }
+
+    uint32_t buildCell(const std::vector<LayoutPoint> &positions, uint32_t first, uint32_t count, float left,
+                       float top, float size, int depth) {
+        uint32_t index = static_cast<uint32_t>(cells.size());
+        cells.push_back({0, 0, left, top, size, first, count, {none, none, none, none}});
+        if (count > leafSize && depth < maxDepth) {
+            float half = size / 2, midX = left + half, midY = top + half;
+            auto begin = order.begin() + first, end = begin + count;
+            auto below = std::partition(begin, end, [&](uint32_t user) { return positions[user].y < midY; });
+            auto upperRight = std::partition(begin, below, [&](uint32_t user) { return positions[user].x >= midX; });
+            auto lowerRight = std::partition(below, end, [&](uint32_t user) { return positions[user].x >= midX; });
+            const std::array<decltype(begin), 5> bounds = {begin, upperRight, below, lowerRight, end};
+            const float offsets[4][2] = {{half, 0}, {0, 0}, {half, half}, {0, half}};
+            for (int quadrant = 0; quadrant < 4; ++quadrant) {
+                uint32_t childCount = static_cast<uint32_t>(bounds[quadrant + 1] - bounds[quadrant]);
+                if (childCount > 0) {
+                    uint32_t childFirst = static_cast<uint32_t>(bounds[quadrant] - order.begin());
+                    uint32_t child = buildCell(positions, childFirst, childCount, left + offsets[quadrant][0],
+                                               top + offsets[quadrant][1], half, depth + 1);
+                    cells[index].children[quadrant] = child;
+                }
+            }
+        }
+        double x = 0, y = 0;
+        if (cells[index].leaf()) {
+            for (uint32_t i = first; i < first + count; ++i) {
+                x += positions[order[i]].x;
+                y += positions[order[i]].y;
+            }
+        } else {
+            for (uint32_t child : cells[index].children) {
+                if (child != none) {
+                    x += double(cells[child].x) * cells[child].count;
+                    y += double(cells[child].y) * cells[child].count;
+                }
+            }
+        }
+        cells[index].x = static_cast<float>(x / count);
+        cells[index].y = static_cast<float>(y / count);
+        return index;
+    }
+};
+
+class ForceLayout {
+public:
+    explicit ForceLayout(LayoutOptions options = {}, ThreadPool &pool = ThreadPool::shared())
+        : options(options), pool(pool) {}
+
+    // Lay out every user from scratch, starting from a uniform scatter over
+    // a disc with room for everyone
+    std::vector<LayoutPoint> compute(const GraphView &graph, LayoutStats *stats = nullptr) {
+        auto started = std::chrono::steady_clock::now();
+        uint32_t n = graph.userCount();
+        std::vector<LayoutPoint> positions(n);
+        float radius = options.idealLength * std::sqrt(float(n));
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        auto uniform = [&] {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            return float(state >> 40) / float(1 << 24);
+        };
+        for (LayoutPoint &p : positions) {
+            float r = radius * std::sqrt(uniform()), angle = 6.2831853f * uniform();
+            p = {r * std::cos(angle), r * std::sin(angle)};
+        }
+
+        size_t steps = options.iterations;
+        if (steps == 0) {
+            steps = std::clamp<size_t>(20000000 / std::max<uint32_t>(n, 1), 50, 300);
+        }
+        std::vector<uint32_t> everyone(n);
+        for (uint32_t user = 0; user < n; ++user) {
+            everyone[user] = user;
+        }
+        relax(graph, positions, everyone, {}, steps, radius / 4);
+        record(stats, n, n, steps, false, started);
+        return positions;
+    }
+
+    // Update `positions`, a layout of the first positions.size() users when
+    // their degrees were `degrees`, for the current graph
+    void extend(const GraphView &graph, std::vector<LayoutPoint> &positions, const std::vector<uint32_t> &degrees,
+                LayoutStats *stats = nullptr) {
+        auto started = std::chrono::steady_clock::now();
+        uint32_t n = graph.userCount();
+        uint32_t placed = static_cast<uint32_t>(positions.size());
+
+        // Users that are new or gained connections move; everyone else stays
+        std::vector<uint32_t> moving, still;
+        for (uint32_t user = 0; user < n; ++user) {
+            if (user >= placed || graph.degree(user) != degrees[user]) {
+                moving.push_back(user);
+            } else {
+                still.push_back(user);
+            }
+        }
+
+        // New users in id order, so neighbours added before them are placed already
+        positions.resize(n);
+        LayoutPoint centre = centroid(positions, placed);
+        float spread = options.idealLength * std::sqrt(float(std::max<uint32_t>(placed, 1)));
+        for (uint32_t user = placed; user < n; ++user) {
+            float x = 0, y = 0;
+            uint32_t known = 0;
+            for (uint32_t neighbor : graph.neighbors(user)) {
+                if (neighbor < user) {
+                    x += positions[neighbor].x;
+                    y += positions[neighbor].y;
+                    ++known;
+                }
+            }
+            // Offset along the golden angle so users added together do not coincide
+            LayoutPoint start = known > 0 ? LayoutPoint{x / known, y / known} : centre;
+            float offset = known > 0 ? options.idealLength / 2 : spread, angle = user * 2.39996323f;
+            positions[user] = {start.x + offset * std::cos(angle), start.y + offset * std::sin(angle)};
+        }
+
+        relax(graph, positions, moving, still, moving.empty() ? 0 : options.relaxSteps, options.idealLength);
+        record(stats, n, moving.size(), moving.empty() ? 0 : options.relaxSteps, true, started);
+    }
+
+private:
+    LayoutOptions options;
+    ThreadPool &pool;
+
+    // Run `steps` steps moving only `moving`; `still` users repel but stay put
+    void relax(const GraphView &graph, std::vector<LayoutPoint> &positions, const std::vector<uint32_t> &moving,
+               const std::vector<uint32_t> &still, size_t steps, float startTemperature) {
+        LayoutQuadTree fixed, live;
+        fixed.build(positions, still);
+        LayoutPoint centre = centroid(positions, static_cast<uint32_t>(positions.size()));
+        float k = options.idealLength;
+        float strength = k * k;
+        std::vector<LayoutPoint> displacement(moving.size());
+        for (size_t step = 0; step < steps; ++step) {
+            float temperature = startTemperature * (1 - float(step) / steps) + k * 0.01f;
+            live.build(positions, moving);
+            pool.parallelFor(moving.size(), 256, [&](size_t begin, size_t end, unsigned) {
+                for (size_t i = begin; i < end; ++i) {
+                    uint32_t user = moving[i];
+                    LayoutPoint p = positions[user];
+                    float fx = 0, fy = 0;
+                    live.repel(positions, user, p, options.theta, strength, fx, fy);
+                    fixed.repel(positions, user, p, options.theta, strength, fx, fy);
+                    for (uint32_t neighbor : graph.neighbors(user)) {
+                        float dx = p.x - positions[neighbor].x, dy = p.y - positions[neighbor].y;
+                        float d = std::sqrt(dx * dx + dy * dy);
+                        fx -= dx * d / k;
+                        fy -= dy * d / k;
+                    }
+                    fx -= (p.x - centre.x) * options.gravity;
+                    fy -= (p.y - centre.y) * options.gravity;
+
+                    float length = std::sqrt(fx * fx + fy * fy);
+                    float scale = length > temperature ? temperature / length : 1.0f;
+                    displacement[i] = {fx * scale, fy * scale};
+                }
+            });
+            for (size_t i = 0; i < moving.size(); ++i) {
+                positions[moving[i]].x += displacement[i].x;
+                positions[moving[i]].y += displacement[i].y;
+            }
+        }
+    }
+
+    static LayoutPoint centroid(const std::vector<LayoutPoint> &positions, uint32_t count) {
+        double x = 0, y = 0;
+        for (uint32_t user = 0; user < count; ++user) {
+            x += positions[user].x;
+            y += positions[user].y;
+        }
+        return count > 0 ? LayoutPoint{float(x / count), float(y / count)} : LayoutPoint{};
+    }
+
+    void record(LayoutStats *stats, size_t users, size_t moved, size_t steps, bool incremental,
+                std::chrono::steady_clock::time_point started) const {
+        if (stats != nullptr) {
+            stats->users = users;
+            stats->moved = moved;
+            stats->iterations = steps;
+            stats->incremental = incremental;
+            stats->threads = pool.size();
+            stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        }
+    }
+};
+
+// Layout cache file: LayoutCacheHeader, then one LayoutCacheEntry per user.
+// Connections are only ever added, so a user whose degree still matches its
+// entry has gained no connection since the layout was computed; the degrees
+// tell extend() exactly which part of the network changed.
+constexpr char layoutCacheMagic[8] = {'S', 'N', 'E', 'T', 'L', 'A', 'Y', 'T'};
+constexpr uint32_t layoutCacheVersion = 1;
+
+struct LayoutCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t userCount;
+};
+
+struct LayoutCacheEntry {
+    float x, y;
+    uint32_t degree; // degree of the user when it was placed
+};
+
+// Write the layout of `graph` to `path` atomically
+inline bool writeLayoutCache(const std::string &path, const GraphView &graph,
+                             const std::vector<LayoutPoint> &positions) {
+    LayoutCacheHeader header{};
+    memcpy(header.magic, layoutCacheMagic, sizeof(header.magic));
+    header.version = layoutCacheVersion;
+    header.userCount = positions.size();
+    std::vector<LayoutCacheEntry> entries(positions.size());
+    for (size_t user = 0; user < positions.size(); ++user) {
+        entries[user] = {positions[user].x, positions[user].y, graph.degree(static_cast<uint32_t>(user))};
+    }
+
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(LayoutCacheEntry));
+    out.close();
+    if (!out || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Read a cached layout and the degrees it was computed at; false if the
+// file is missing or malformed
+inline bool readLayoutCache(const std::string &path, std::vector<LayoutPoint> &positions,
+                            std::vector<uint32_t> &degrees) {
+    MappedFile file(path);
+    if (file.size() < sizeof(LayoutCacheHeader)) {
+        return false;
+    }
+    const auto *header = reinterpret_cast<const LayoutCacheHeader *>(file.data());
+    if (memcmp(header->magic, layoutCacheMagic, sizeof(header->magic)) != 0 ||
+        header->version != layoutCacheVersion ||
+        (file.size() - sizeof(LayoutCacheHeader)) / sizeof(LayoutCacheEntry) < header->userCount) {
+        return false;
+    }
+    const auto *entries = reinterpret_cast<const LayoutCacheEntry *>(file.data() + sizeof(LayoutCacheHeader));
+    positions.resize(header->userCount);
+    degrees.resize(header->userCount);
+    for (size_t user = 0; user < header->userCount; ++user) {
+        positions[user] = {entries[user].x, entries[user].y};
+        degrees[user] = entries[user].degree;
+    }
+    return true;
+}
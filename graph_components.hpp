@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+// Disjoint-set forest over dense user ids: one tree per connected component.
+// GraphCore unites the endpoints of every edge it stores, so whether two users
+// are connected at all is answered without a traversal.
+//
+// Union by size keeps every tree O(log n) deep, so the read-only find() is
+// safe to call from const code and from several threads at once. unite()
+// also halves the paths it walks and bulk loads flatten the forest, which
+// keeps the trees nearly flat in practice (find() is effectively O(α(n))).
+class ComponentForest {
+public:
+    // n singleton components
+    void reset(size_t n) {
+        parent.resize(n);
+        std::iota(parent.begin(), parent.end(), 0u);
+        sizes.assign(n, 1);
+        count = n;
+    }
+
+    // Append one new node as its own component
+    void add() {
+        parent.push_back(static_cast<uint32_t>(parent.size()));
+        sizes.push_back(1);
+        ++count;
+    }
+
+    // Root of x's tree; the same for two nodes exactly when they share a component
+    uint32_t find(uint32_t x) const {
+        while (parent[x] != x) {
+            x = parent[x];
+        }
+        return x;
+    }
+
+    // Merge the components of a and b; false if they already were one
+    bool unite(uint32_t a, uint32_t b) {
+        a = findHalving(a);
+        b = findHalving(b);
+        if (a == b) {
+            return false;
+        }
+        if (sizes[a] < sizes[b]) {
+            std::swap(a, b);
+        }
+        parent[b] = a;
+        sizes[a] += sizes[b];
+        --count;
+        return true;
+    }
+
+    // Point every node straight at its root
+    void flatten() {
+        for (uint32_t x = 0; x < parent.size(); ++x) {
+            parent[x] = find(x);
+        }
+    }
+
+    uint32_t sizeOf(uint32_t x) const { return sizes[find(x)]; }
+
+    size_t componentCount() const { return count; }
+
+    // Size of every component, largest first
+    std::vector<uint32_t> componentSizes() const {
+        std::vector<uint32_t> result;
+        result.reserve(count);
+        for (uint32_t x = 0; x < parent.size(); ++x) {
+            if (parent[x] == x) {
+                result.push_back(sizes[x]);
+            }
+        }
+        std::sort(result.begin(), result.end(), std::greater<uint32_t>());
+        return result;
+    }
+
+    // One node of every component (its root), largest component first
+    std::vector<uint32_t> roots() const {
+        std::vector<uint32_t> result;
+        result.reserve(count);
+        for (uint32_t x = 0; x < parent.size(); ++x) {
+            if (parent[x] == x) {
+                result.push_back(x);
+            }
+        }
+        std::stable_sort(result.begin(), result.end(),
+                         [this](uint32_t a, uint32_t b) { return sizes[a] > sizes[b]; });
+        return result;
+    }
+
+private:
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> sizes; // component size, valid at roots only
+    size_t count = 0;
+
+    uint32_t findHalving(uint32_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+};
@@ -0,0 +1,359 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "graph_components.hpp"
+
+// Integer graph core shared by the network programs.
+// Usernames are interned once to dense uint32_t ids and the adjacency is kept
+// in compressed-sparse-row (CSR) form: the neighbours of user `u` are
+// targets[offsets[u] .. offsets[u + 1]). A single new edge does not touch
+// the CSR arrays: each endpoint's row is copied once into an overflow row,
+// which neighbors() and degree() read instead, and the new id is inserted
+// there in order. Overflow rows are folded back into the CSR arrays when
+// they grow past a fraction of the adjacency or when the raw arrays are
+// requested, so interleaved connects and queries cost O(degree), not O(E).
+// New users just append an empty row; bulk loads go through addEdges().
+// Edges are a set: duplicates are dropped on insert and on every merge, and
+// hasEdge() answers membership by hashing for hub rows and by binary search
+// for ordinary (sorted) rows. Connected components are tracked as edges
+// arrive (see ComponentForest).
+class GraphCore {
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    // Contiguous, read-only list of neighbour ids
+    struct NeighborRange {
+        const uint32_t *first = nullptr;
+        const uint32_t *last = nullptr;
+
+        const uint32_t *begin() const { return first; }
+        const uint32_t *end() const { return last; }
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+    };
+
+    // Return the id of a user, interning the name if it is new
+    uint32_t internUser(std::string_view name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        uint32_t id = static_cast<uint32_t>(names.size());
+        names.emplace_back(name);
+        ids.emplace(names.back(), id);
+        offsets.push_back(offsets.back());
+        hubSlot.push_back(npos);
+        overflowSlot.push_back(npos);
+        components.add();
+        ++changes;
+        return id;
+    }
+
+    // Look up a user id without interning; npos if the name is unknown
+    uint32_t findUser(std::string_view name) const {
+        auto it = ids.find(name);
+        return it == ids.end() ? npos : it->second;
+    }
+
+    bool contains(std::string_view name) const { return ids.find(name) != ids.end(); }
+
+    const std::string &nameOf(uint32_t id) const { return names[id]; }
+
+    uint32_t userCount() const { return static_cast<uint32_t>(names.size()); }
+
+    // Number of undirected connections
+    size_t connectionCount() const { return (targets.size() + overflowAdded) / 2; }
+
+    // Bumped by every change to the users or edges; caches derived from the
+    // graph compare it to know when they are stale
+    uint64_t version() const { return changes; }
+
+    // Rows with at least this many neighbours also get a hash set
+    static constexpr uint32_t hubDegree = 256;
+
+    // Add an undirected edge between two existing ids.
+    // Returns false (and changes nothing) for self-loops and existing edges.
+    bool addEdge(uint32_t u, uint32_t v) {
+        if (u == v || hasEdge(u, v)) {
+            return false;
+        }
+        insertOverflow(u, v);
+        insertOverflow(v, u);
+        overflowAdded += 2;
+        components.unite(u, v);
+        ++changes;
+        if (overflowEntries > targets.size() / overflowShare + overflowSlack) {
+            compact();
+        }
+        return true;
+    }
+
+    // Whether u and v are connected: a hash lookup for hub rows, a binary
+    // search of the (CSR or overflow) row otherwise
+    bool hasEdge(uint32_t u, uint32_t v) const {
+        if (hubSlot[u] != npos) {
+            return hubSets[hubSlot[u]].count(v) != 0;
+        }
+        NeighborRange row = neighbors(u);
+        return std::binary_search(row.begin(), row.end(), v);
+    }
+
+    // Representative of id's connected component: two users have the same one
+    // exactly when some path joins them. Representatives change as components merge.
+    uint32_t componentOf(uint32_t id) const { return components.find(id); }
+
+    bool sameComponent(uint32_t u, uint32_t v) const { return components.find(u) == components.find(v); }
+
+    // Number of users in id's component (1 for a user without connections)
+    uint32_t componentSize(uint32_t id) const { return components.sizeOf(id); }
+
+    size_t componentCount() const { return components.componentCount(); }
+
+    // Size of every component, largest first
+    std::vector<uint32_t> componentSizes() const { return components.componentSizes(); }
+
+    // One representative per component, largest component first
+    std::vector<uint32_t> componentRoots() const { return components.roots(); }
+
+    // Sorted neighbour ids; valid until the graph is next changed
+    NeighborRange neighbors(uint32_t id) const {
+        if (overflowSlot[id] != npos) {
+            const std::vector<uint32_t> &row = overflowRows[overflowSlot[id]].targets;
+            return {row.data(), row.data() + row.size()};
+        }
+        return {targets.data() + offsets[id], targets.data() + offsets[id + 1]};
+    }
+
+    uint32_t degree(uint32_t id) const {
+        if (overflowSlot[id] != npos) {
+            return static_cast<uint32_t>(overflowRows[overflowSlot[id]].targets.size());
+        }
+        return static_cast<uint32_t>(offsets[id + 1] - offsets[id]);
+    }
+
+    // CSR arrays for serialisation and bulk readers (overflow rows are
+    // folded in first)
+    const std::vector<uint64_t> &rowOffsets() const {
+        compact();
+        return offsets;
+    }
+
+    const std::vector<uint32_t> &adjacency() const {
+        compact();
+        return targets;
+    }
+
+    // Replace the adjacency with ready-made CSR arrays that cover every
+    // interned user (offsets has userCount() + 1 entries, rows sorted)
+    void assignAdjacency(const uint64_t *rowOffsets, const uint32_t *adjacency) {
+        size_t n = names.size();
+        offsets.assign(rowOffsets, rowOffsets + n + 1);
+        targets.assign(adjacency, adjacency + offsets[n]);
+        overflowRows.clear();
+        overflowSlot.assign(n, npos);
+        overflowEntries = overflowAdded = 0;
+        buildHubSets();
+        components.reset(n);
+        for (uint32_t u = 0; u < n; ++u) {
+            for (uint64_t i = offsets[u]; i < offsets[u + 1] && targets[i] < u; ++i) {
+                components.unite(u, targets[i]);
+            }
+        }
+        components.flatten();
+        ++changes;
+    }
+
+    // Add many undirected edges at once: one counting-sort pass merges them
+    // into the CSR arrays instead of staging each one. Self-loops and edges
+    // that already exist (or repeat within `edges`) are dropped.
+    void addEdges(const std::vector<std::pair<uint32_t, uint32_t>> &edges) {
+        compact();
+        mergeEntries(edges.size() * 2, [&](auto &&emit) {
+            for (const auto &[u, v] : edges) {
+                if (u != v) {
+                    emit(u, v);
+                    emit(v, u);
+                }
+            }
+        });
+        for (const auto &[u, v] : edges) {
+            components.unite(u, v);
+        }
+        components.flatten();
+        ++changes;
+    }
+
+    // Fold the overflow rows into the CSR arrays. Every row is already
+    // sorted, so this is one copy pass plus rebuilding the hub sets.
+    void compact() const {
+        if (overflowRows.empty()) {
+            return;
+        }
+        size_t n = names.size();
+        std::vector<uint64_t> newOffsets(n + 1, 0);
+        for (size_t u = 0; u < n; ++u) {
+            newOffsets[u + 1] = newOffsets[u] + degree(static_cast<uint32_t>(u));
+        }
+        std::vector<uint32_t> newTargets(newOffsets[n]);
+        for (size_t u = 0; u < n; ++u) {
+            NeighborRange row = neighbors(static_cast<uint32_t>(u));
+            std::copy(row.begin(), row.end(), newTargets.begin() + newOffsets[u]);
+        }
+        offsets.swap(newOffsets);
+        targets.swap(newTargets);
+        for (const OverflowRow &row : overflowRows) {
+            overflowSlot[row.id] = npos;
+        }
+        overflowRows.clear();
+        overflowRows.shrink_to_fit();
+        overflowEntries = overflowAdded = 0;
+        buildHubSets();
+    }
+
+private:
+    // A row that has gained edges since the last compaction: a sorted copy
+    // of its CSR row plus the new neighbours
+    struct OverflowRow {
+        uint32_t id;
+        std::vector<uint32_t> targets;
+    };
+
+    // Overflow rows may hold this share of the adjacency (plus a fixed
+    // slack for small graphs) before addEdge() folds them in
+    static constexpr size_t overflowShare = 8;
+    static constexpr size_t overflowSlack = 1 << 16;
+
+    std::deque<std::string> names;                        // id -> username (stable storage)
+    std::unordered_map<std::string_view, uint32_t> ids;   // username -> id, views into `names`
+    mutable std::vector<uint64_t> offsets{0};             // CSR row offsets, userCount + 1 entries
+    mutable std::vector<uint32_t> targets;                // CSR neighbour ids
+    mutable std::vector<OverflowRow> overflowRows;        // rows changed since the last compaction
+    mutable std::vector<uint32_t> overflowSlot;           // id -> index into overflowRows, npos if none
+    mutable size_t overflowEntries = 0;                   // ids held by overflowRows
+    mutable size_t overflowAdded = 0;                     // directed entries not yet in `targets`
+    uint64_t changes = 0;                                 // see version()
+    ComponentForest components;                           // connected components of the edges so far
+    mutable std::vector<uint32_t> hubSlot;                // id -> index into hubSets, npos if not a hub
+    mutable std::vector<std::unordered_set<uint32_t>> hubSets; // neighbour sets of hub rows
+
+    // Insert `v` into u's overflow row, copying u's CSR row there first
+    void insertOverflow(uint32_t u, uint32_t v) {
+        if (overflowSlot[u] == npos) {
+            overflowSlot[u] = static_cast<uint32_t>(overflowRows.size());
+            overflowRows.push_back({u, std::vector<uint32_t>(targets.begin() + offsets[u],
+                                                             targets.begin() + offsets[u + 1])});
+            overflowEntries += overflowRows.back().targets.size();
+        }
+        std::vector<uint32_t> &row = overflowRows[overflowSlot[u]].targets;
+        row.insert(std::lower_bound(row.begin(), row.end(), v), v);
+        ++overflowEntries;
+        if (hubSlot[u] != npos) {
+            hubSets[hubSlot[u]].insert(v);
+        }
+    }
+
+    // Index every row of degree >= hubDegree in a hash set
+    void buildHubSets() const {
+        size_t n = offsets.size() - 1;
+        hubSlot.assign(n, npos);
+        hubSets.clear();
+        for (size_t u = 0; u < n; ++u) {
+            if (offsets[u + 1] - offsets[u] >= hubDegree) {
+                hubSlot[u] = static_cast<uint32_t>(hubSets.size());
+                hubSets.emplace_back(targets.begin() + offsets[u], targets.begin() + offsets[u + 1]);
+            }
+        }
+    }
+
+    // Counting-sort merge of `entryCount` directed entries into the CSR
+    // arrays. `forEach(emit)` must call emit(from, to) for every entry and
+    // is invoked twice (count, then scatter). Duplicate entries are removed.
+    template <typename ForEach>
+    void mergeEntries(size_t entryCount, ForEach forEach) const {
+        size_t n = names.size();
+        size_t oldRows = offsets.size() - 1;
+        std::vector<uint64_t> newOffsets(n + 1, 0);
+        for (size_t u = 0; u < oldRows; ++u) {
+            newOffsets[u + 1] = offsets[u + 1] - offsets[u];
+        }
+        forEach([&](uint32_t from, uint32_t) { newOffsets[from + 1]++; });
+        for (size_t u = 0; u < n; ++u) {
+            newOffsets[u + 1] += newOffsets[u];
+        }
+
+        // Scatter: old row first, new entries behind it
+        std::vector<uint32_t> newTargets(newOffsets[n]);
+        std::vector<uint64_t> cursor(newOffsets.begin(), newOffsets.end() - 1);
+        for (size_t u = 0; u < oldRows; ++u) {
+            cursor[u] = std::copy(targets.begin() + offsets[u], targets.begin() + offsets[u + 1],
+                                  newTargets.begin() + newOffsets[u]) - newTargets.begin();
+        }
+        std::vector<uint64_t> oldEnd(cursor);
+        forEach([&](uint32_t from, uint32_t to) { newTargets[cursor[from]++] = to; });
+        cursor.clear();
+        cursor.shrink_to_fit();
+
+        // Sort each row's new tail, merge it with the old sorted part and
+        // drop repeats; rowEnd records where each deduplicated row stops.
+        // Large merges split the rows across threads by entry count.
+        std::vector<uint64_t> rowEnd(oldEnd);
+        auto sortRows = [&](size_t firstRow, size_t lastRow) {
+            for (size_t u = firstRow; u < lastRow; ++u) {
+                if (oldEnd[u] == newOffsets[u + 1]) {
+                    continue;
+                }
+                auto rowBegin = newTargets.begin() + newOffsets[u];
+                auto mid = newTargets.begin() + oldEnd[u];
+                auto last = newTargets.begin() + newOffsets[u + 1];
+                std::sort(mid, last);
+                std::inplace_merge(rowBegin, mid, last);
+                rowEnd[u] = std::unique(rowBegin, last) - newTargets.begin();
+            }
+        };
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        if (entryCount < (1u << 20) || threads == 1) {
+            sortRows(0, n);
+        } else {
+            std::vector<std::thread> workers;
+            size_t row = 0;
+            for (unsigned t = 1; t <= threads; ++t) {
+                uint64_t boundary = newOffsets[n] * t / threads;
+                size_t end = t == threads ? n
+                                          : std::upper_bound(newOffsets.begin() + row, newOffsets.end() - 1, boundary) -
+                                                newOffsets.begin();
+                workers.emplace_back(sortRows, row, end);
+                row = end;
+            }
+            for (std::thread &worker : workers) {
+                worker.join();
+            }
+        }
+
+        // Close the gaps left by duplicates (rows only ever move left)
+        uint64_t write = 0;
+        for (size_t u = 0; u < n; ++u) {
+            uint64_t rowStart = newOffsets[u];
+            newOffsets[u] = write;
+            if (write != rowStart) {
+                std::copy(newTargets.begin() + rowStart, newTargets.begin() + rowEnd[u], newTargets.begin() + write);
+            }
+            write += rowEnd[u] - rowStart;
+        }
+        newOffsets[n] = write;
+        newTargets.resize(write);
+
+        offsets.swap(newOffsets);
+        targets.swap(newTargets);
+        buildHubSets();
+    }
+};
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "graph_core.hpp"
+#include "thread_pool.hpp"
+
+// Parallel level-synchronous BFS for whole-graph traversals (single-source
+// distances, eccentricity, diameter sweeps, landmark tables).
+//
+// Every level is one parallelFor on the pool, in one of two directions (same
+// switching rule as kHopNeighborhood):
+//   - top-down: workers take chunks of the frontier, claim unvisited
+//     neighbours with an atomic fetch_or on the visited bitmap (exactly one
+//     worker wins each user) and append them to their own next-frontier list
+//   - bottom-up: workers take ranges of 64-user bitmap words; the owner of a
+//     word checks its unvisited users against the frontier bitmap and writes
+//     the word back, so no atomics are needed
+// Buffers are allocated without being touched and first written by the pool
+// in the same contiguous word ranges the bottom-up levels use, so on NUMA
+// machines each worker's pages tend to land on its own node.
+class ParallelBfs {
+public:
+    static constexpr uint32_t unreachable = UINT32_MAX;
+
+    explicit ParallelBfs(ThreadPool &pool = ThreadPool::shared()) : pool(pool), workers(pool.size()) {}
+
+    // Distances from `source` to every user; valid until the next run()
+    void run(const GraphCore &graph, uint32_t source) {
+        constexpr uint64_t alpha = 14, beta = 24;
+        graph.compact(); // workers only read the CSR arrays
+        offsets = graph.rowOffsets().data();
+        targets = graph.adjacency().data();
+        n = graph.userCount();
+        words = (size_t(n) + 63) / 64;
+        reset();
+
+        dist[source] = 0;
+        visited[source >> 6].fetch_or(uint64_t(1) << (source & 63), std::memory_order_relaxed);
+        frontier.assign(1, source);
+        levels.assign(1, 1);
+
+        uint64_t frontierSize = 1;
+        uint64_t frontierEdges = degree(source);
+        uint64_t unvisitedEdges = graph.adjacency().size() - frontierEdges;
+        bool bottomUp = false;
+        for (uint32_t level = 1; frontierSize > 0; ++level) {
+            if (!bottomUp && frontierEdges * alpha > unvisitedEdges) {
+                listToBitmap();
+                bottomUp = true;
+            } else if (bottomUp && frontierSize * beta < n) {
+                bitmapToList();
+                bottomUp = false;
+            }
+            for (WorkerState &state : workers) {
+                state.found = 0;
+                state.edges = 0;
+            }
+            if (bottomUp) {
+                stepBottomUp(level);
+            } else {
+                stepTopDown(level);
+            }
+
+            frontierSize = frontierEdges = 0;
+            for (const WorkerState &state : workers) {
+                frontierSize += state.found;
+                frontierEdges += state.edges;
+            }
+            unvisitedEdges -= frontierEdges;
+            if (frontierSize > 0) {
+                levels.push_back(frontierSize);
+            }
+        }
+    }
+
+    uint32_t userCount() const { return n; }
+
+    uint32_t distance(uint32_t user) const { return dist[user]; }
+
+    const uint32_t *distances() const { return dist.get(); }
+
+    // levelSizes()[d]: users exactly d hops from the source (index 0 is the source)
+    const std::vector<uint64_t> &levelSizes() const { return levels; }
+
+    // Largest finite distance from the source
+    uint32_t eccentricity() const { return static_cast<uint32_t>(levels.size() - 1); }
+
+    uint64_t reachableCount() const {
+        uint64_t sum = 0;
+        for (uint64_t size : levels) {
+            sum += size;
+        }
+        return sum;
+    }
+
+    // Some user at the largest distance from the source
+    uint32_t farthestUser() const {
+        uint32_t best = 0;
+        for (uint32_t user = 0; user < n; ++user) {
+            if (dist[user] != unreachable && (dist[best] == unreachable || dist[user] > dist[best])) {
+                best = user;
+            }
+        }
+        return best;
+    }
+
+private:
+    static constexpr size_t wordGrain = 256;   // bitmap words (16384 users) per chunk
+    static constexpr size_t vertexGrain = 256; // frontier entries per chunk
+
+    struct alignas(64) WorkerState {
+        std::vector<uint32_t> next; // users this worker claimed in the current level
+        uint64_t found = 0;
+        uint64_t edges = 0;         // sum of their degrees
+    };
+
+    ThreadPool &pool;
+    std::vector<WorkerState> workers;
+    const uint64_t *offsets = nullptr;
+    const uint32_t *targets = nullptr;
+    uint32_t n = 0;
+    size_t words = 0;
+    size_t capacityWords = 0;
+    std::unique_ptr<uint32_t[]> dist;
+    std::unique_ptr<std::atomic<uint64_t>[]> visited;
+    std::unique_ptr<uint64_t[]> frontierBits;
+    std::unique_ptr<uint64_t[]> nextBits;
+    std::vector<uint32_t> frontier;
+    std::vector<uint64_t> levels;
+
+    uint64_t degree(uint32_t u) const { return offsets[u + 1] - offsets[u]; }
+
+    // Grow the buffers if needed (uninitialised), then clear them in parallel.
+    // Bits past the last user are marked visited so bottom-up never sees them.
+    void reset() {
+        if (capacityWords < words) {
+            capacityWords = words;
+            dist.reset(new uint32_t[words * 64]);
+            visited.reset(new std::atomic<uint64_t>[words]);
+            frontierBits.reset(new uint64_t[words]);
+            nextBits.reset(new uint64_t[words]);
+        }
+        pool.parallelFor(words, wordGrain, [&](size_t begin, size_t end, unsigned) {
+            for (size_t w = begin; w < end; ++w) {
+                uint64_t padding = (w + 1) * 64 > n ? ~uint64_t(0) << (n - w * 64) : 0;
+                visited[w].store(padding, std::memory_order_relaxed);
+                frontierBits[w] = 0;
+                nextBits[w] = 0;
+                std::fill(dist.get() + w * 64, dist.get() + (w + 1) * 64, unreachable);
+            }
+        });
+    }
+
+    void listToBitmap() {
+        pool.parallelFor(words, wordGrain, [&](size_t begin, size_t end, unsigned) {
+            std::fill(frontierBits.get() + begin, frontierBits.get() + end, 0);
+        });
+        for (uint32_t u : frontier) {
+            frontierBits[u >> 6] |= uint64_t(1) << (u & 63);
+        }
+    }
+
+    void bitmapToList() {
+        frontier.clear();
+        for (size_t w = 0; w < words; ++w) {
+            for (uint64_t bits = frontierBits[w]; bits != 0; bits &= bits - 1) {
+                frontier.push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits)));
+            }
+        }
+    }
+
+    void stepTopDown(uint32_t level) {
+        pool.parallelFor(frontier.size(), vertexGrain, [&](size_t begin, size_t end, unsigned worker) {
+            WorkerState &state = workers[worker];
+            for (size_t i = begin; i < end; ++i) {
+                uint32_t u = frontier[i];
+                for (uint64_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+                    uint32_t v = targets[e];
+                    uint64_t bit = uint64_t(1) << (v & 63);
+                    std::atomic<uint64_t> &word = visited[v >> 6];
+                    if ((word.load(std::memory_order_relaxed) & bit) != 0 ||
+                        (word.fetch_or(bit, std::memory_order_relaxed) & bit) != 0) {
+                        continue;
+                    }
+                    dist[v] = level;
+                    state.next.push_back(v);
+                    state.edges += degree(v);
+                }
+            }
+        });
+        frontier.clear();
+        for (WorkerState &state : workers) {
+            state.found = state.next.size();
+            frontier.insert(frontier.end(), state.next.begin(), state.next.end());
+            state.next.clear();
+        }
+    }
+
+    void stepBottomUp(uint32_t level) {
+        pool.parallelFor(words, wordGrain, [&](size_t begin, size_t end, unsigned worker) {
+            WorkerState &state = workers[worker];
+            for (size_t w = begin; w < end; ++w) {
+                uint64_t seen = visited[w].load(std::memory_order_relaxed);
+                uint64_t claimed = 0;
+                for (uint64_t bits = ~seen; bits != 0; bits &= bits - 1) {
+                    uint32_t v = static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits));
+                    for (uint64_t e = offsets[v]; e < offsets[v + 1]; ++e) {
+                        uint32_t x = targets[e];
+                        if ((frontierBits[x >> 6] >> (x & 63)) & 1) {
+                            claimed |= bits & -bits;
+                            dist[v] = level;
+                            state.edges += degree(v);
+                            break;
+                        }
+                    }
+                }
+                visited[w].store(seen | claimed, std::memory_order_relaxed);
+                nextBits[w] = claimed;
+                state.found += __builtin_popcountll(claimed);
+            }
+        });
+        std::swap(frontierBits, nextBits);
+    }
+};
+
+// Hop distance from `source` to every user (ParallelBfs::unreachable if none)
+inline std::vector<uint32_t> distancesFrom(const GraphCore &graph, uint32_t source,
+                                           ThreadPool &pool = ThreadPool::shared()) {
+    ParallelBfs bfs(pool);
+    bfs.run(graph, source);
+    return std::vector<uint32_t>(bfs.distances(), bfs.distances() + bfs.userCount());
+}
+
+// Lower bound on the diameter of source's component by repeated double
+// sweeps: BFS from a user, then from the farthest user it found
+inline uint32_t diameterLowerBound(const GraphCore &graph, uint32_t source, unsigned sweeps = 2,
+                                   ThreadPool &pool = ThreadPool::shared()) {
+    ParallelBfs bfs(pool);
+    uint32_t best = 0;
+    for (unsigned i = 0; i < sweeps * 2; ++i) {
+        bfs.run(graph, source);
+        best = std::max(best, bfs.eccentricity());
+        source = bfs.farthestUser();
+    }
+    return best;
+}
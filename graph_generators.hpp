@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Synthetic networks for benchmarking. Every generator produces an edge list
+// over users 0..userCount-1 plus one value per user for each attribute the
+// programs index, drawn from skewed (Zipf-like) distributions so a few
+// departments, interests, ... are large and most are small.
+
+enum class GraphModel {
+    ErdosRenyi,      // uniform random pairs
+    BarabasiAlbert,  // preferential attachment: power-law degrees with hubs
+    DepartmentGroups // most edges stay inside the user's department
+};
+
+struct GeneratorOptions {
+    GraphModel model = GraphModel::ErdosRenyi;
+    uint32_t userCount = 100000;
+    uint32_t averageDegree = 10;
+    uint32_t departmentCount = 20;
+    double sameDepartmentShare = 0.8; // DepartmentGroups only
+    uint64_t seed = 1;
+};
+
+struct SyntheticNetwork {
+    std::vector<std::string> names;
+    std::vector<std::pair<uint32_t, uint32_t>> edges; // may contain repeats; self-loops removed
+    std::vector<std::string> departments, roles, interests, games, aims; // per user
+};
+
+// Samples indices 0..size-1 with probability proportional to 1 / (rank + 1)^exponent
+class ZipfSampler {
+public:
+    ZipfSampler(size_t size, double exponent) : cumulative(size) {
+        double total = 0;
+        for (size_t i = 0; i < size; ++i) {
+            total += 1.0 / std::pow(i + 1.0, exponent);
+            cumulative[i] = total;
+        }
+        for (double &c : cumulative) {
+            c /= total;
+        }
+    }
+
+    template <typename Rng>
+    size_t operator()(Rng &rng) const {
+        double x = std::uniform_real_distribution<double>(0, 1)(rng);
+        return std::min(cumulative.size() - 1,
+                        size_t(std::lower_bound(cumulative.begin(), cumulative.end(), x) - cumulative.begin()));
+    }
+
+private:
+    std::vector<double> cumulative;
+};
+
+inline const char *graphModelName(GraphModel model) {
+    switch (model) {
+    case GraphModel::BarabasiAlbert:
+        return "barabasi-albert";
+    case GraphModel::DepartmentGroups:
+        return "department";
+    default:
+        return "erdos-renyi";
+    }
+}
+
+// Parse "er" / "ba" / "dept" (or the full names); false if unknown
+inline bool parseGraphModel(const std::string &text, GraphModel &model) {
+    if (text == "er" || text == "erdos-renyi") {
+        model = GraphModel::ErdosRenyi;
+    } else if (text == "ba" || text == "barabasi-albert") {
+        model = GraphModel::BarabasiAlbert;
+    } else if (text == "dept" || text == "department") {
+        model = GraphModel::DepartmentGroups;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline SyntheticNetwork generateNetwork(const GeneratorOptions &options) {
+    std::mt19937_64 rng(options.seed);
+    uint32_t n = std::max<uint32_t>(options.userCount, 2);
+    SyntheticNetwork net;
+
+    static const char *roleNames[] = {"student", "ta", "researcher", "faculty", "staff"};
+    static const char *interestNames[] = {"ai", "systems", "theory", "networks", "graphics", "security",
+                                          "databases", "hci", "robotics", "biology"};
+    static const char *gameNames[] = {"chess", "football", "cricket", "valorant", "minecraft", "go",
+                                      "tennis", "fifa", "dota", "poker"};
+    static const char *aimNames[] = {"engineer", "scientist", "founder", "professor", "designer",
+                                     "doctor", "artist", "manager"};
+    ZipfSampler departmentOf(std::max<uint32_t>(options.departmentCount, 1), 1.0);
+    ZipfSampler roleOf(5, 1.2), interestOf(10, 0.8), gameOf(10, 0.8), aimOf(8, 0.8);
+
+    net.names.reserve(n);
+    std::vector<uint32_t> department(n);
+    for (uint32_t u = 0; u < n; ++u) {
+        net.names.push_back("user" + std::to_string(u));
+        department[u] = static_cast<uint32_t>(departmentOf(rng));
+        net.departments.push_back("dept" + std::to_string(department[u]));
+        net.roles.emplace_back(roleNames[roleOf(rng)]);
+        net.interests.emplace_back(interestNames[interestOf(rng)]);
+        net.games.emplace_back(gameNames[gameOf(rng)]);
+        net.aims.emplace_back(aimNames[aimOf(rng)]);
+    }
+
+    uint64_t edgeCount = uint64_t(n) * options.averageDegree / 2;
+    net.edges.reserve(edgeCount);
+    std::uniform_int_distribution<uint32_t> anyUser(0, n - 1);
+    auto addEdge = [&](uint32_t u, uint32_t v) {
+        if (u != v) {
+            net.edges.emplace_back(u, v);
+        }
+    };
+
+    if (options.model == GraphModel::ErdosRenyi) {
+        for (uint64_t e = 0; e < edgeCount; ++e) {
+            addEdge(anyUser(rng), anyUser(rng));
+        }
+    } else if (options.model == GraphModel::BarabasiAlbert) {
+        // Each new user attaches to `m` existing endpoints picked from the
+        // list of all edge endpoints, i.e. proportionally to degree
+        uint32_t m = std::max<uint32_t>(1, options.averageDegree / 2);
+        std::vector<uint32_t> endpoints;
+        endpoints.reserve(edgeCount * 2);
+        for (uint32_t u = 1; u <= std::min(m, n - 1); ++u) {
+            addEdge(u, 0);
+            endpoints.push_back(u);
+            endpoints.push_back(0);
+        }
+        for (uint32_t u = m + 1; u < n; ++u) {
+            for (uint32_t i = 0; i < m; ++i) {
+                uint32_t v = endpoints[std::uniform_int_distribution<size_t>(0, endpoints.size() - 1)(rng)];
+                addEdge(u, v);
+                endpoints.push_back(u);
+                endpoints.push_back(v);
+            }
+        }
+    } else {
+        std::vector<std::vector<uint32_t>> members(std::max<uint32_t>(options.departmentCount, 1));
+        for (uint32_t u = 0; u < n; ++u) {
+            members[department[u]].push_back(u);
+        }
+        std::bernoulli_distribution sameDepartment(options.sameDepartmentShare);
+        for (uint64_t e = 0; e < edgeCount; ++e) {
+            uint32_t u = anyUser(rng);
+            const std::vector<uint32_t> &group = members[department[u]];
+            uint32_t v = sameDepartment(rng) && group.size() > 1
+                             ? group[std::uniform_int_distribution<size_t>(0, group.size() - 1)(rng)]
+                             : anyUser(rng);
+            addEdge(u, v);
+        }
+    }
+    return net;
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "graph_core.hpp"
+
+// Intersection of sorted id lists, used for mutual-connection queries.
+// mutualConnections() picks a kernel from the two degrees:
+//   - both users are hubs with a bitset: AND the bitsets word by word
+//   - one side has a bitset: probe it once per id of the other side
+//   - degrees differ by 32x or more: galloping search in the longer list
+//   - otherwise: block-wise SIMD merge (AVX2 if compiled in, else SSE2)
+// Every kernel appends ids in ascending order.
+
+// Append every id in both a[0..na) and b[0..nb) by exponential search in b
+inline void intersectGalloping(const uint32_t *a, size_t na, const uint32_t *b, size_t nb,
+                               std::vector<uint32_t> &out) {
+    size_t pos = 0; // every b[< pos] is smaller than the current a[i]
+    for (size_t i = 0; i < na && pos < nb; ++i) {
+        uint32_t x = a[i];
+        size_t probe = pos, step = 1;
+        while (probe < nb && b[probe] < x) {
+            pos = probe + 1;
+            probe += step;
+            step <<= 1;
+        }
+        pos = std::lower_bound(b + pos, b + std::min(probe + 1, nb), x) - b;
+        if (pos < nb && b[pos] == x) {
+            out.push_back(x);
+            ++pos;
+        }
+    }
+}
+
+inline void intersectScalar(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, std::vector<uint32_t> &out) {
+    size_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            out.push_back(a[i]);
+            ++i;
+            ++j;
+        }
+    }
+}
+
+// Merge in fixed-size blocks: compare a block of `a` with every rotation of
+// a block of `b` in registers, emit the matches, then advance whichever
+// block ends with the smaller id (both if equal). Lists hold unique ids,
+// so each match is found exactly once; the remainder is merged scalar.
+inline void intersectMerge(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, std::vector<uint32_t> &out) {
+    size_t i = 0, j = 0;
+#if defined(__AVX2__)
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while (i + 8 <= na && j + 8 <= nb) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + j));
+        __m256i match = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; ++r) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+        }
+        for (unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(match)); mask != 0; mask &= mask - 1) {
+            out.push_back(a[i + __builtin_ctz(mask)]);
+        }
+        uint32_t lastA = a[i + 7], lastB = b[j + 7];
+        i += lastA <= lastB ? 8 : 0;
+        j += lastB <= lastA ? 8 : 0;
+    }
+#elif defined(__SSE2__)
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+        __m128i match = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        for (unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(match)); mask != 0; mask &= mask - 1) {
+            out.push_back(a[i + __builtin_ctz(mask)]);
+        }
+        uint32_t lastA = a[i + 3], lastB = b[j + 3];
+        i += lastA <= lastB ? 4 : 0;
+        j += lastB <= lastA ? 4 : 0;
+    }
+#endif
+    intersectScalar(a + i, na - i, b + j, nb - j, out);
+}
+
+// Intersect two sorted lists of any lengths with the cheaper list kernel
+inline void intersectSorted(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, std::vector<uint32_t> &out) {
+    if (na > nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (na == 0) {
+        return;
+    }
+    if (nb / na >= 32) {
+        intersectGalloping(a, na, b, nb, out);
+    } else {
+        intersectMerge(a, na, b, nb, out);
+    }
+}
+
+// Dense neighbour bitsets for the highest-degree users of one graph.
+// A user qualifies when its degree is at least both GraphCore::hubDegree
+// and userCount / 256 (so the bitset is at most 8x the size of its row).
+// Bitsets are built on first use until `budgetBytes` is spent and dropped
+// whenever the graph's version() changes.
+struct IntersectScratch {
+    static constexpr size_t budgetBytes = 64 << 20;
+
+    const GraphCore *graph = nullptr;
+    uint64_t version = 0;
+    size_t words = 0;                    // uint64 words per bitset
+    size_t remaining = 0;                // bitsets that still fit in the budget
+    std::vector<uint32_t> slot;          // user id -> bitset index, npos if none yet
+    std::vector<std::vector<uint64_t>> bitsets;
+
+    void prepare(const GraphCore &g) {
+        if (graph == &g && version == g.version()) {
+            return;
+        }
+        graph = &g;
+        version = g.version();
+        words = (g.userCount() + 63) / 64;
+        remaining = words == 0 ? 0 : budgetBytes / (words * sizeof(uint64_t));
+        slot.assign(g.userCount(), GraphCore::npos);
+        bitsets.clear();
+    }
+
+    bool qualifies(uint32_t user) const {
+        uint32_t d = graph->degree(user);
+        return d >= GraphCore::hubDegree && uint64_t(d) * 256 >= graph->userCount();
+    }
+
+    // Bitset of `user`'s neighbours, or nullptr if the user is not a hub
+    const uint64_t *bitsetOf(uint32_t user) {
+        if (slot[user] != GraphCore::npos) {
+            return bitsets[slot[user]].data();
+        }
+        if (remaining == 0 || !qualifies(user)) {
+            return nullptr;
+        }
+        --remaining;
+        slot[user] = static_cast<uint32_t>(bitsets.size());
+        std::vector<uint64_t> &bits = bitsets.emplace_back(words, 0);
+        for (uint32_t v : graph->neighbors(user)) {
+            bits[v >> 6] |= uint64_t(1) << (v & 63);
+        }
+        return bits.data();
+    }
+};
+
+inline IntersectScratch &threadIntersectScratch() {
+    thread_local IntersectScratch scratch;
+    return scratch;
+}
+
+// Ids connected to both u and v, ascending
+inline std::vector<uint32_t> mutualConnections(const GraphCore &graph, uint32_t u, uint32_t v,
+                                               IntersectScratch &scratch = threadIntersectScratch()) {
+    scratch.prepare(graph);
+    std::vector<uint32_t> out;
+    if (graph.degree(u) > graph.degree(v)) {
+        std::swap(u, v);
+    }
+    auto small = graph.neighbors(u), large = graph.neighbors(v);
+    if (small.empty()) {
+        return out;
+    }
+
+    // A word-wise AND beats probing once the bitsets are short relative to
+    // the smaller row (sequential words are ~4x cheaper than random probes)
+    const uint64_t *largeBits = scratch.bitsetOf(v);
+    const uint64_t *smallBits = nullptr;
+    if (largeBits != nullptr && scratch.words < 4 * small.size()) {
+        smallBits = scratch.bitsetOf(u);
+    }
+    if (smallBits != nullptr) {
+        for (size_t w = 0; w < scratch.words; ++w) {
+            for (uint64_t bits = smallBits[w] & largeBits[w]; bits != 0; bits &= bits - 1) {
+                out.push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits)));
+            }
+        }
+    } else if (largeBits != nullptr) {
+        for (uint32_t x : small) {
+            if ((largeBits[x >> 6] >> (x & 63)) & 1) {
+                out.push_back(x);
+            }
+        }
+    } else {
+        intersectSorted(small.begin(), small.size(), large.begin(), large.size(), out);
+    }
+    return out;
+}
+
+// Mutual connections restricted to the sorted id list `allowed`, e.g. the
+// posting list of an attribute value from AttributeIndex::usersWith()
+inline std::vector<uint32_t> mutualConnections(const GraphCore &graph, uint32_t u, uint32_t v,
+                                               const std::vector<uint32_t> &allowed,
+                                               IntersectScratch &scratch = threadIntersectScratch()) {
+    std::vector<uint32_t> mutual = mutualConnections(graph, u, v, scratch);
+    std::vector<uint32_t> out;
+    intersectSorted(mutual.data(), mutual.size(), allowed.data(), allowed.size(), out);
+    return out;
+}
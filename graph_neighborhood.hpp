@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "graph_core.hpp"
+
+// Everyone within k hops of a user, by direction-optimizing BFS.
+//
+// Each level is expanded one of two ways:
+//   - top-down: scan the rows of the frontier and claim unvisited neighbours
+//   - bottom-up: scan the row of every unvisited user and stop at the first
+//     neighbour found in the frontier bitmap
+// Top-down is cheaper while the frontier is small. Once the frontier's rows
+// hold more than 1/alpha of the edges still leading to unvisited users,
+// bottom-up wins: most unvisited users meet a frontier neighbour within a
+// few probes, so a level costs about one probe per unvisited user instead of
+// one per frontier edge. The search returns to top-down when the frontier
+// shrinks below 1/beta of the users (alpha = 14, beta = 24, after Beamer et
+// al., "Direction-Optimizing Breadth-First Search").
+
+// Users exactly h hops away are counts[h - 1] / ids[h - 1]; the source itself
+// is not included. ids is only filled when requested, each hop ascending.
+// The search stops after the first hop that reaches nobody new (count 0),
+// so there may be fewer than k entries.
+struct HopNeighborhood {
+    std::vector<uint64_t> counts;
+    std::vector<std::vector<uint32_t>> ids;
+
+    uint64_t total() const {
+        uint64_t sum = 0;
+        for (uint64_t count : counts) {
+            sum += count;
+        }
+        return sum;
+    }
+};
+
+// Reusable per-thread bitmaps and frontier lists
+struct NeighborhoodScratch {
+    std::vector<uint64_t> visited;
+    std::vector<uint64_t> frontierBits;
+    std::vector<uint64_t> nextBits;
+    std::vector<uint32_t> frontier;
+    std::vector<uint32_t> next;
+
+    // Clear the visited bitmap for `n` users; bits past the last user count
+    // as visited so bottom-up scans never see them
+    void prepare(size_t n) {
+        size_t words = (n + 63) / 64;
+        visited.assign(words, 0);
+        if (n % 64 != 0) {
+            visited.back() = ~uint64_t(0) << (n % 64);
+        }
+        frontierBits.resize(words);
+        nextBits.resize(words);
+    }
+};
+
+inline NeighborhoodScratch &threadNeighborhoodScratch() {
+    thread_local NeighborhoodScratch scratch;
+    return scratch;
+}
+
+inline HopNeighborhood kHopNeighborhood(const GraphCore &graph, uint32_t source, uint32_t k, bool withIds,
+                                        NeighborhoodScratch &scratch = threadNeighborhoodScratch()) {
+    constexpr uint64_t alpha = 14, beta = 24;
+    uint32_t n = graph.userCount();
+    size_t words = (size_t(n) + 63) / 64;
+    auto degree = [&](uint32_t u) { return graph.degree(u); };
+    auto test = [](const std::vector<uint64_t> &bits, uint32_t u) { return (bits[u >> 6] >> (u & 63)) & 1; };
+
+    HopNeighborhood result;
+    scratch.prepare(n);
+    std::vector<uint64_t> &visited = scratch.visited;
+    visited[source >> 6] |= uint64_t(1) << (source & 63);
+    scratch.frontier.assign(1, source);
+
+    uint64_t frontierSize = 1;
+    uint64_t frontierEdges = degree(source);
+    uint64_t unvisitedEdges = graph.connectionCount() * 2 - frontierEdges;
+    bool bottomUp = false;
+
+    for (uint32_t hop = 1; hop <= k && frontierSize > 0; ++hop) {
+        if (!bottomUp && frontierEdges * alpha > unvisitedEdges) {
+            std::fill(scratch.frontierBits.begin(), scratch.frontierBits.end(), 0);
+            for (uint32_t u : scratch.frontier) {
+                scratch.frontierBits[u >> 6] |= uint64_t(1) << (u & 63);
+            }
+            bottomUp = true;
+        } else if (bottomUp && frontierSize * beta < n) {
+            scratch.frontier.clear();
+            for (size_t w = 0; w < words; ++w) {
+                for (uint64_t bits = scratch.frontierBits[w]; bits != 0; bits &= bits - 1) {
+                    scratch.frontier.push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits)));
+                }
+            }
+            bottomUp = false;
+        }
+
+        uint64_t found = 0, foundEdges = 0;
+        if (!bottomUp) {
+            scratch.next.clear();
+            for (uint32_t u : scratch.frontier) {
+                for (uint32_t v : graph.neighbors(u)) {
+                    if (!test(visited, v)) {
+                        visited[v >> 6] |= uint64_t(1) << (v & 63);
+                        scratch.next.push_back(v);
+                        foundEdges += degree(v);
+                    }
+                }
+            }
+            found = scratch.next.size();
+            if (withIds) {
+                std::vector<uint32_t> &level = result.ids.emplace_back(scratch.next);
+                std::sort(level.begin(), level.end());
+            }
+            scratch.frontier.swap(scratch.next);
+        } else {
+            for (size_t w = 0; w < words; ++w) {
+                uint64_t claimed = 0;
+                for (uint64_t bits = ~visited[w]; bits != 0; bits &= bits - 1) {
+                    uint32_t v = static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits));
+                    for (uint32_t conn : graph.neighbors(v)) {
+                        if (test(scratch.frontierBits, conn)) {
+                            claimed |= bits & -bits;
+                            foundEdges += degree(v);
+                            break;
+                        }
+                    }
+                }
+                scratch.nextBits[w] = claimed;
+                found += __builtin_popcountll(claimed);
+            }
+            for (size_t w = 0; w < words; ++w) {
+                visited[w] |= scratch.nextBits[w];
+            }
+            if (withIds) {
+                std::vector<uint32_t> &level = result.ids.emplace_back();
+                level.reserve(found);
+                for (size_t w = 0; w < words; ++w) {
+                    for (uint64_t bits = scratch.nextBits[w]; bits != 0; bits &= bits - 1) {
+                        level.push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits)));
+                    }
+                }
+            }
+            scratch.frontierBits.swap(scratch.nextBits);
+        }
+
+        result.counts.push_back(found);
+        frontierSize = found;
+        frontierEdges = foundEdges;
+        unvisitedEdges -= foundEdges;
+    }
+    return result;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "graph_core.hpp"
+
+// Reusable per-thread BFS state. Each side (0 = from the source, 1 = from the
+// target) stamps nodes with the current epoch instead of clearing a visited
+// array, so a query only touches the nodes it actually reaches.
+struct PathScratch {
+    std::vector<uint32_t> stamp[2];
+    std::vector<uint32_t> parent[2];
+    std::vector<uint32_t> depth[2];
+    std::vector<uint32_t> frontier[2];
+    std::vector<uint32_t> next;
+    uint32_t epoch = 0;
+
+    // Grow to `n` nodes and start a fresh epoch
+    void prepare(size_t n) {
+        for (int side = 0; side < 2; ++side) {
+            if (stamp[side].size() < n) {
+                stamp[side].resize(n, 0);
+                parent[side].resize(n);
+                depth[side].resize(n);
+            }
+        }
+        if (++epoch == 0) {
+            // Epoch counter wrapped: clear the stamps once and start over
+            for (int side = 0; side < 2; ++side) {
+                std::fill(stamp[side].begin(), stamp[side].end(), 0);
+            }
+            epoch = 1;
+        }
+    }
+
+    bool seen(int side, uint32_t node) const { return stamp[side][node] == epoch; }
+
+    void visit(int side, uint32_t node, uint32_t from, uint32_t dist) {
+        stamp[side][node] = epoch;
+        parent[side][node] = from;
+        depth[side][node] = dist;
+    }
+};
+
+inline PathScratch &threadPathScratch() {
+    thread_local PathScratch scratch;
+    return scratch;
+}
+
+// Shortest path between two ids as a list of ids (source first).
+// Bidirectional BFS: each round expands one complete level of whichever
+// side has the cheaper frontier (fewer adjacency entries to scan).
+// Returns an empty vector when the users are not connected; users in
+// different components are rejected up front without any search.
+inline std::vector<uint32_t> shortestPathBetween(const GraphCore &graph, uint32_t source, uint32_t target,
+                                                 PathScratch &scratch = threadPathScratch()) {
+    if (source == target) {
+        return {source};
+    }
+    if (!graph.sameComponent(source, target)) {
+        return {};
+    }
+
+    scratch.prepare(graph.userCount());
+    scratch.visit(0, source, GraphCore::npos, 0);
+    scratch.visit(1, target, GraphCore::npos, 0);
+    scratch.frontier[0].assign(1, source);
+    scratch.frontier[1].assign(1, target);
+
+    while (!scratch.frontier[0].empty() && !scratch.frontier[1].empty()) {
+        size_t cost[2] = {0, 0};
+        for (int side = 0; side < 2; ++side) {
+            for (uint32_t node : scratch.frontier[side]) {
+                cost[side] += graph.degree(node);
+            }
+        }
+        int side = cost[0] <= cost[1] ? 0 : 1;
+        int other = 1 - side;
+
+        // Expand the whole level and keep the best meeting point in it
+        uint32_t bestLength = UINT32_MAX;
+        uint32_t meet = GraphCore::npos;
+        scratch.next.clear();
+        for (uint32_t node : scratch.frontier[side]) {
+            uint32_t dist = scratch.depth[side][node] + 1;
+            for (uint32_t neighbor : graph.neighbors(node)) {
+                if (scratch.seen(side, neighbor)) {
+                    continue;
+                }
+                scratch.visit(side, neighbor, node, dist);
+                scratch.next.push_back(neighbor);
+                if (scratch.seen(other, neighbor) && dist + scratch.depth[other][neighbor] < bestLength) {
+                    bestLength = dist + scratch.depth[other][neighbor];
+                    meet = neighbor;
+                }
+            }
+        }
+
+        if (meet != GraphCore::npos) {
+            std::vector<uint32_t> path;
+            for (uint32_t node = meet; node != GraphCore::npos; node = scratch.parent[0][node]) {
+                path.push_back(node);
+            }
+            std::reverse(path.begin(), path.end());
+            for (uint32_t node = scratch.parent[1][meet]; node != GraphCore::npos; node = scratch.parent[1][node]) {
+                path.push_back(node);
+            }
+            return path;
+        }
+        scratch.frontier[side].swap(scratch.next);
+    }
+
+    return {};
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "graph_core.hpp"
+
+// A suggested connection and how many connections it shares with the user
+struct Suggestion {
+    uint32_t user;
+    uint32_t mutualCount;
+};
+
+// Ranking order: more mutual connections first, lower id breaks ties
+inline bool ranksHigher(const Suggestion &a, const Suggestion &b) {
+    return a.mutualCount != b.mutualCount ? a.mutualCount > b.mutualCount : a.user < b.user;
+}
+
+// Dense per-thread counters for the friend-of-friend scan. Only the entries
+// listed in `touched` are non-zero, so resetting costs as much as the scan.
+struct SuggestScratch {
+    std::vector<uint32_t> count;    // user id -> mutual connections with the query user
+    std::vector<uint32_t> excluded; // epoch stamp for the user and their direct connections
+    std::vector<uint32_t> touched;  // ids whose counter is non-zero
+    std::vector<Suggestion> heap;   // bounded min-heap of the best candidates so far
+    uint32_t epoch = 0;
+
+    void prepare(size_t n) {
+        if (count.size() < n) {
+            count.resize(n, 0);
+            excluded.resize(n, 0);
+        }
+        if (++epoch == 0) {
+            std::fill(excluded.begin(), excluded.end(), 0);
+            epoch = 1;
+        }
+    }
+};
+
+inline SuggestScratch &threadSuggestScratch() {
+    thread_local SuggestScratch scratch;
+    return scratch;
+}
+
+// The `k` users with the most mutual connections to `user`, best first.
+// k == 0 returns every candidate. Work is proportional to the user's
+// two-hop neighbourhood plus O(candidates * log k) for the heap.
+inline std::vector<Suggestion> suggestTopK(const GraphCore &graph, uint32_t user, size_t k,
+                                           SuggestScratch &scratch = threadSuggestScratch()) {
+    scratch.prepare(graph.userCount());
+    scratch.touched.clear();
+
+    auto connections = graph.neighbors(user);
+    scratch.excluded[user] = scratch.epoch;
+    for (uint32_t conn : connections) {
+        scratch.excluded[conn] = scratch.epoch;
+    }
+
+    for (uint32_t conn : connections) {
+        for (uint32_t connOfConn : graph.neighbors(conn)) {
+            if (scratch.excluded[connOfConn] == scratch.epoch) {
+                continue;
+            }
+            if (scratch.count[connOfConn]++ == 0) {
+                scratch.touched.push_back(connOfConn);
+            }
+        }
+    }
+
+    size_t limit = k == 0 ? scratch.touched.size() : k;
+    std::vector<Suggestion> &heap = scratch.heap;
+    heap.clear();
+    for (uint32_t candidate : scratch.touched) {
+        Suggestion s{candidate, scratch.count[candidate]};
+        scratch.count[candidate] = 0;
+        if (heap.size() < limit) {
+            heap.push_back(s);
+            std::push_heap(heap.begin(), heap.end(), ranksHigher);
+        } else if (limit > 0 && ranksHigher(s, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), ranksHigher);
+            heap.back() = s;
+            std::push_heap(heap.begin(), heap.end(), ranksHigher);
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end(), ranksHigher);
+    return heap;
+}
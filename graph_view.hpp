@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_span)
+#include <span>
+#endif
+
+#include "graph_core.hpp"
+
+// Neighbour ids of one user: std::span where the library has it (C++20),
+// otherwise a minimal read-only span with the same interface
+#if defined(__cpp_lib_span)
+using NeighborSpan = std::span<const uint32_t>;
+#else
+class NeighborSpan {
+public:
+    NeighborSpan() = default;
+    NeighborSpan(const uint32_t *first, size_t count) : first(first), count(count) {}
+
+    const uint32_t *data() const { return first; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const uint32_t &operator[](size_t i) const { return first[i]; }
+    const uint32_t *begin() const { return first; }
+    const uint32_t *end() const { return first + count; }
+
+private:
+    const uint32_t *first = nullptr;
+    size_t count = 0;
+};
+#endif
+
+// Read-only, zero-copy view of a GraphCore for the visualizer, the
+// exporters and analytics.
+//
+// Creating a view folds recent edges into the CSR arrays once; after that
+// every call reads those arrays directly: neighbors() is a span into them,
+// names are the interned strings, nothing is copied and nothing is
+// compacted again. A view costs a few pointers, so it is passed by value
+// and may be shared by any number of reader threads.
+//
+// It stays valid while the graph is not mutated. Adding a user or a
+// connection may reallocate the arrays; current() tells whether that
+// happened since the view was made, and a new view must be taken then.
+class GraphView {
+public:
+    explicit GraphView(const GraphCore &graph)
+        : graph(&graph), offsets(graph.rowOffsets().data()), targets(graph.adjacency().data()),
+          users(graph.userCount()), connections(graph.connectionCount()), version(graph.version()) {}
+
+    // User ids are 0 .. userCount() - 1
+    uint32_t userCount() const { return users; }
+
+    // Number of undirected connections
+    size_t connectionCount() const { return connections; }
+
+    NeighborSpan neighbors(uint32_t id) const {
+        return NeighborSpan(targets + offsets[id], static_cast<size_t>(offsets[id + 1] - offsets[id]));
+    }
+
+    uint32_t degree(uint32_t id) const { return static_cast<uint32_t>(offsets[id + 1] - offsets[id]); }
+
+    const std::string &nameOf(uint32_t id) const { return graph->nameOf(id); }
+
+    // Id of a user by name; GraphCore::npos if there is none
+    uint32_t findUser(std::string_view name) const { return graph->findUser(name); }
+
+    // Visit every connection once, as (lower id, higher id), in id order
+    template <typename Visit>
+    void forEachConnection(Visit visit) const {
+        for (uint32_t user = 0; user < users; ++user) {
+            for (uint32_t conn : neighbors(user)) {
+                if (user < conn) {
+                    visit(user, conn);
+                }
+            }
+        }
+    }
+
+    // False once the graph has changed since the view was taken
+    bool current() const { return graph->version() == version; }
+
+private:
+    const GraphCore *graph;
+    const uint64_t *offsets; // CSR row offsets, users + 1 entries
+    const uint32_t *targets; // CSR neighbour ids
+    uint32_t users;
+    size_t connections;
+    uint64_t version;
+};
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "graph_core.hpp"
+#include "graph_distances.hpp"
+#include "mapped_file.hpp"
+#include "thread_pool.hpp"
+
+// Landmark distance oracle.
+//
+// A few landmark users are chosen and the hop distance from each of them to
+// every user is stored. For users s, t and a landmark l the triangle
+// inequality gives
+//     |d(s,l) - d(t,l)|  <=  d(s,t)  <=  d(s,l) + d(l,t)
+// so one row read per user bounds d(s,t) in microseconds, and walking down
+// the stored distances of the best landmark yields an actual path of the
+// upper-bound length. When the two bounds meet, that path is a shortest one.
+//
+// Layout: LandmarkIndexHeader, uint32 landmarks[landmarkCount] padded to 8
+// bytes, then uint8 distances[userCount][landmarkCount] (one row per user, so
+// a query reads two short contiguous rows). Distances of 255 or more, and
+// users a landmark cannot reach, are stored as `unknownDistance` and ignored.
+// Like the suggestion table, the file is tied to the write-ahead log
+// sequence it was computed at and only served while nothing has changed.
+constexpr char landmarkIndexMagic[8] = {'S', 'N', 'E', 'T', 'L', 'M', 'R', 'K'};
+constexpr uint32_t landmarkIndexVersion = 1;
+
+struct LandmarkIndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t landmarkCount;
+    uint64_t userCount;
+    uint64_t logSequence; // write-ahead log sequence the index reflects
+};
+
+enum class LandmarkSelection {
+    Degree, // best-connected users, skipping neighbours of those already chosen
+    Random  // uniform sample of users with at least one connection
+};
+
+struct LandmarkIndexStats {
+    size_t landmarks = 0;
+    size_t users = 0;
+    double seconds = 0;
+    unsigned threads = 0;
+};
+
+// Bounds on the hop distance between two users. upper is exact when it
+// equals lower; both are DistanceEstimate::unknown if no landmark reaches
+// both users.
+struct DistanceEstimate {
+    static constexpr uint32_t unknown = UINT32_MAX;
+
+    uint32_t lower = 0;
+    uint32_t upper = unknown;
+    uint32_t landmark = GraphCore::npos; // slot of the landmark giving `upper`
+
+    bool exact() const { return upper != unknown && lower == upper; }
+};
+
+// Up to `count` landmark ids, chosen as `selection` describes
+inline std::vector<uint32_t> chooseLandmarks(const GraphCore &graph, size_t count, LandmarkSelection selection,
+                                             uint64_t seed = 1) {
+    uint32_t n = graph.userCount();
+    std::vector<uint32_t> candidates;
+    for (uint32_t user = 0; user < n; ++user) {
+        if (graph.degree(user) > 0) {
+            candidates.push_back(user);
+        }
+    }
+    std::vector<uint32_t> chosen;
+    if (selection == LandmarkSelection::Random) {
+        std::mt19937_64 rng(seed);
+        std::shuffle(candidates.begin(), candidates.end(), rng);
+        candidates.resize(std::min(count, candidates.size()));
+        return candidates;
+    }
+
+    // Adjacent hubs see almost the same distances, so a hub next to an
+    // earlier landmark is only taken if nothing else is left
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [&](uint32_t a, uint32_t b) { return graph.degree(a) > graph.degree(b); });
+    std::vector<bool> covered(n, false);
+    std::vector<uint32_t> skipped;
+    for (uint32_t user : candidates) {
+        if (chosen.size() == count) {
+            break;
+        }
+        if (covered[user]) {
+            skipped.push_back(user);
+            continue;
+        }
+        chosen.push_back(user);
+        for (uint32_t neighbor : graph.neighbors(user)) {
+            covered[neighbor] = true;
+        }
+    }
+    for (size_t i = 0; i < skipped.size() && chosen.size() < count; ++i) {
+        chosen.push_back(skipped[i]);
+    }
+    return chosen;
+}
+
+// Choose up to `count` landmarks, run one parallel BFS from each and write
+// the index to `path` atomically
+inline bool buildLandmarkIndex(const std::string &path, const GraphCore &graph, size_t count,
+                               LandmarkSelection selection, uint64_t logSequence,
+                               LandmarkIndexStats *stats = nullptr, ThreadPool &pool = ThreadPool::shared()) {
+    auto started = std::chrono::steady_clock::now();
+    graph.compact(); // workers only read the graph
+    uint32_t n = graph.userCount();
+    std::vector<uint32_t> landmarks = chooseLandmarks(graph, std::min<size_t>(count, UINT32_MAX), selection);
+    size_t width = landmarks.size();
+
+    std::vector<uint8_t> table(size_t(n) * width);
+    ParallelBfs bfs(pool);
+    for (size_t slot = 0; slot < width; ++slot) {
+        bfs.run(graph, landmarks[slot]);
+        const uint32_t *dist = bfs.distances();
+        pool.parallelFor(n, 4096, [&](size_t begin, size_t end, unsigned) {
+            for (size_t user = begin; user < end; ++user) {
+                table[user * width + slot] = static_cast<uint8_t>(std::min<uint32_t>(dist[user], 255));
+            }
+        });
+    }
+
+    LandmarkIndexHeader header{};
+    memcpy(header.magic, landmarkIndexMagic, sizeof(header.magic));
+    header.version = landmarkIndexVersion;
+    header.landmarkCount = static_cast<uint32_t>(width);
+    header.userCount = n;
+    header.logSequence = logSequence;
+
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    static const char padding[8] = {};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(landmarks.data()), width * sizeof(uint32_t));
+    out.write(padding, (width * sizeof(uint32_t)) % 8);
+    out.write(reinterpret_cast<const char *>(table.data()), table.size());
+    out.close();
+    if (!out || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    if (stats != nullptr) {
+        stats->landmarks = width;
+        stats->users = n;
+        stats->threads = pool.size();
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+    return true;
+}
+
+// Read-only view of an index file
+class LandmarkIndex {
+public:
+    static constexpr uint8_t unknownDistance = 255;
+
+    // Map `path`; false (and an empty index) if it is missing or malformed
+    bool open(const std::string &path) {
+        close();
+        auto mapped = std::make_unique<MappedFile>(path);
+        const char *base = mapped->data();
+        size_t length = mapped->size();
+        if (length < sizeof(LandmarkIndexHeader)) {
+            return false;
+        }
+        const auto *h = reinterpret_cast<const LandmarkIndexHeader *>(base);
+        if (memcmp(h->magic, landmarkIndexMagic, sizeof(h->magic)) != 0 || h->version != landmarkIndexVersion ||
+            h->landmarkCount == 0) {
+            return false;
+        }
+        uint64_t tableAt = sizeof(LandmarkIndexHeader) + (uint64_t(h->landmarkCount) * sizeof(uint32_t) + 7) / 8 * 8;
+        if (tableAt > length || (length - tableAt) / h->landmarkCount < h->userCount) {
+            return false;
+        }
+        const auto *ids = reinterpret_cast<const uint32_t *>(base + sizeof(LandmarkIndexHeader));
+        for (uint32_t slot = 0; slot < h->landmarkCount; ++slot) {
+            if (ids[slot] >= h->userCount) {
+                return false;
+            }
+        }
+        header = h;
+        landmarkIds = ids;
+        table = reinterpret_cast<const uint8_t *>(base + tableAt);
+        file = std::move(mapped);
+        return true;
+    }
+
+    void close() {
+        file.reset();
+        header = nullptr;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+
+    // Whether the index describes the network at `logSequence` with `userCount` users
+    bool covers(uint64_t logSequence, uint32_t userCount) const {
+        return isOpen() && header->logSequence == logSequence && header->userCount == userCount;
+    }
+
+    size_t landmarkCount() const { return isOpen() ? header->landmarkCount : 0; }
+
+    uint32_t landmark(size_t slot) const { return landmarkIds[slot]; }
+
+    // Stored distance from the landmark in `slot` to `user`
+    uint8_t distance(uint32_t user, size_t slot) const { return table[size_t(user) * header->landmarkCount + slot]; }
+
+    // Triangle-inequality bounds on d(source, target) from every landmark
+    DistanceEstimate estimate(uint32_t source, uint32_t target) const {
+        DistanceEstimate result;
+        result.lower = source == target ? 0 : 1;
+        const uint8_t *rowS = table + size_t(source) * header->landmarkCount;
+        const uint8_t *rowT = table + size_t(target) * header->landmarkCount;
+        for (uint32_t slot = 0; slot < header->landmarkCount; ++slot) {
+            if (rowS[slot] == unknownDistance || rowT[slot] == unknownDistance) {
+                continue;
+            }
+            uint32_t ds = rowS[slot], dt = rowT[slot];
+            result.lower = std::max(result.lower, ds > dt ? ds - dt : dt - ds);
+            if (ds + dt < result.upper) {
+                result.upper = ds + dt;
+                result.landmark = slot;
+            }
+        }
+        if (result.upper == DistanceEstimate::unknown) {
+            result.lower = DistanceEstimate::unknown;
+        }
+        return result;
+    }
+
+    // A path from source to target through the landmark of `estimate`
+    // (source first), with detours through the landmark cut short where the
+    // graph has a direct edge. Empty if the estimate found no landmark.
+    std::vector<uint32_t> pathThrough(const GraphCore &graph, uint32_t source, uint32_t target,
+                                      const DistanceEstimate &estimate) const {
+        if (estimate.landmark == GraphCore::npos) {
+            return {};
+        }
+        std::vector<uint32_t> path;
+        std::vector<uint32_t> tail;
+        if (!descend(graph, source, estimate.landmark, path) || !descend(graph, target, estimate.landmark, tail)) {
+            return {};
+        }
+        path.pop_back(); // the landmark ends both walks
+        path.insert(path.end(), tail.rbegin(), tail.rend());
+
+        // Jump from every node to the furthest later node it is adjacent to
+        // (or identical with: the two walks may share a stretch)
+        std::vector<uint32_t> shortened;
+        for (size_t i = 0; i < path.size();) {
+            shortened.push_back(path[i]);
+            size_t next = i + 1;
+            for (size_t j = path.size() - 1; j > i + 1; --j) {
+                if (path[j] == path[i] || graph.hasEdge(path[i], path[j])) {
+                    next = path[j] == path[i] ? j + 1 : j;
+                    break;
+                }
+            }
+            i = next;
+        }
+        return shortened;
+    }
+
+private:
+    std::unique_ptr<MappedFile> file;
+    const LandmarkIndexHeader *header = nullptr;
+    const uint32_t *landmarkIds = nullptr;
+    const uint8_t *table = nullptr;
+
+    // Walk from `user` to the landmark in `slot`, always to a neighbour one
+    // hop closer; appends every node including both ends
+    bool descend(const GraphCore &graph, uint32_t user, size_t slot, std::vector<uint32_t> &walk) const {
+        uint8_t dist = distance(user, slot);
+        walk.push_back(user);
+        while (dist > 0) {
+            uint32_t step = GraphCore::npos;
+            for (uint32_t neighbor : graph.neighbors(user)) {
+                if (distance(neighbor, slot) == dist - 1) {
+                    step = neighbor;
+                    break;
+                }
+            }
+            if (step == GraphCore::npos) {
+                return false; // the graph no longer matches the index
+            }
+            user = step;
+            --dist;
+            walk.push_back(user);
+        }
+        return true;
+    }
+};
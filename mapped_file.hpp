@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only memory mapping of a whole file. Empty or missing files map to
+// an empty view; isOpen() tells a missing or unmappable file from an empty one.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0) {
+            opened = info.st_size == 0;
+            if (info.st_size > 0) {
+                void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    base = static_cast<const char *>(mapped);
+                    length = info.st_size;
+                    opened = true;
+                }
+            }
+        }
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (base != nullptr) {
+            munmap(const_cast<char *>(base), length);
+        }
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool isOpen() const { return opened; }
+    const char *data() const { return base; }
+    size_t size() const { return length; }
+    std::string_view text() const { return {base, length}; }
+
+    // Hint that the file will be read front to back
+    void adviseSequential() const {
+        if (base != nullptr) {
+            madvise(const_cast<char *>(base), length, MADV_SEQUENTIAL);
+        }
+    }
+
+private:
+    const char *base = nullptr;
+    size_t length = 0;
+    bool opened = false;
+};
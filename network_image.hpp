@@ -0,0 +1,566 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "force_layout.hpp"
+#include "graph_view.hpp"
+#include "output_buffer.hpp"
+#include "thread_pool.hpp"
+
+// Headless network images: PPM and PNG rasters, or SVG, with no display.
+//
+// Rasters are drawn in square tiles. Every connection is first binned into
+// the tiles its segment crosses (column by column, so a long connection is
+// listed in a thin band of tiles, not its whole bounding box), every user
+// into the tiles its disc touches. Tiles then render in parallel on the
+// pool, each one writing only its own pixels of the shared image:
+//   - connections with a DDA line rasterizer along the major axis, clipped
+//     to the tile by solving the line equation for the tile's edges; pixels
+//     only depend on the whole segment, so tiles meet without seams
+//   - users as filled discs on top, coloured by department
+// Colours are blended over a white background with a connection opacity
+// that falls as the network gets denser.
+//
+// PNG output is Sub-filtered and deflated with fixed Huffman codes and
+// distance-1 matches only (run-length coding): background and flat colour
+// runs shrink to almost nothing, without a zlib dependency.
+//
+// SVG is streamed: connections as a few long paths, users grouped by
+// department under one fill colour, names as labels for small networks.
+struct ImageOptions {
+    unsigned width = 2048;     // pixels (at most 16384); the height follows the layout's aspect ratio
+    unsigned tileSize = 256;   // edge of one raster tile in pixels
+    unsigned margin = 16;      // pixels kept free around the network
+    size_t maxLabels = 1500;   // SVG only: more users than this get no labels
+};
+
+struct ImageStats {
+    size_t users = 0;
+    size_t edges = 0;
+    unsigned width = 0, height = 0;
+    size_t tiles = 0;
+    double seconds = 0;
+    unsigned threads = 0;
+};
+
+class NetworkImage {
+public:
+    explicit NetworkImage(ImageOptions options = ImageOptions(), ThreadPool &pool = ThreadPool::shared())
+        : options(options), pool(pool) {}
+
+    // Fit the layout into the image. `groupOf` gives every user a department
+    // value id, which picks its colour.
+    void setScene(const GraphView &graph, const std::vector<LayoutPoint> &layout,
+                  const std::vector<uint32_t> &groupOf) {
+        users = graph.userCount();
+        edges.clear();
+        edges.reserve(graph.connectionCount());
+        graph.forEachConnection([&](uint32_t user, uint32_t conn) { edges.push_back({user, conn}); });
+        groups.assign(users, 0);
+        std::copy_n(groupOf.begin(), std::min<size_t>(groupOf.size(), users), groups.begin());
+
+        float left = 0, right = 0, top = 0, bottom = 0;
+        for (uint32_t user = 0; user < users; ++user) {
+            const LayoutPoint &p = layout[user];
+            left = user == 0 ? p.x : std::min(left, p.x);
+            right = user == 0 ? p.x : std::max(right, p.x);
+            top = user == 0 ? p.y : std::min(top, p.y);
+            bottom = user == 0 ? p.y : std::max(bottom, p.y);
+        }
+        float spanX = std::max(right - left, 1.0f), spanY = std::max(bottom - top, 1.0f);
+        width = std::clamp(options.width, 2 * options.margin + 1, maxWidth);
+        float inner = static_cast<float>(width - 2 * options.margin);
+        float scale = inner / spanX;
+        height = static_cast<unsigned>(std::lround(spanY * scale)) + 2 * options.margin;
+        if (height > 4 * width) { // a thin line of users: cap the height instead
+            height = 4 * width;
+            scale = (height - 2 * options.margin) / spanY;
+        }
+        height = std::max(height, 2 * options.margin + 1);
+
+        // Discs shrink as the network fills the picture, down to single pixels
+        radius = users == 0 ? 0 : std::clamp(0.25f * std::sqrt(float(width) * height / users), 0.5f, 6.0f);
+        float offsetX = options.margin + (inner - spanX * scale) / 2;
+        points.resize(users);
+        for (uint32_t user = 0; user < users; ++user) {
+            points[user] = {offsetX + (layout[user].x - left) * scale, options.margin + (layout[user].y - top) * scale};
+        }
+        edgeAlpha = edges.size() > 200000 ? 24 : edges.size() > 20000 ? 64 : edges.size() > 2000 ? 128 : 200;
+        for (int value = 0; value < 256; ++value) {
+            edgeBlend[value] = uint8_t(std::lround(value + (edgeShade - value) * (edgeAlpha / 255.0)));
+        }
+    }
+
+    // Write the scene as PPM (P6), PNG or SVG; false if the file could not be written
+    bool writePPM(const std::string &path, ImageStats *stats = nullptr) {
+        auto started = std::chrono::steady_clock::now();
+        rasterize();
+        OutputBuffer out;
+        if (!out.open(path)) {
+            return false;
+        }
+        out << "P6\n" << width << ' ' << height << "\n255\n";
+        out.write(std::string_view(reinterpret_cast<const char *>(pixels.data()), pixels.size()));
+        record(stats, started);
+        return out.close();
+    }
+
+    bool writePNG(const std::string &path, ImageStats *stats = nullptr) {
+        auto started = std::chrono::steady_clock::now();
+        rasterize();
+        OutputBuffer out;
+        if (!out.open(path)) {
+            return false;
+        }
+        std::string chunk;
+        out.write(std::string_view("\x89PNG\r\n\x1a\n", 8));
+        putBigEndian(chunk, width);
+        putBigEndian(chunk, height);
+        chunk += std::string_view("\x08\x02\x00\x00\x00", 5); // 8-bit RGB, deflate, no interlace
+        writeChunk(out, "IHDR", chunk);
+        writeChunk(out, "IDAT", deflatePixels());
+        writeChunk(out, "IEND", std::string());
+        record(stats, started);
+        return out.close();
+    }
+
+    bool writeSVG(const std::string &path, const GraphView &graph, ImageStats *stats = nullptr) {
+        auto started = std::chrono::steady_clock::now();
+        OutputBuffer out;
+        if (!out.open(path)) {
+            return false;
+        }
+        out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height
+            << "\" viewBox=\"0 0 " << width << ' ' << height << "\">\n";
+        out << "<rect width=\"100%\" height=\"100%\" fill=\"#ffffff\"/>\n";
+
+        constexpr size_t edgesPerPath = 4096;
+        for (size_t first = 0; first < edges.size(); first += edgesPerPath) {
+            out << "<path fill=\"none\" stroke=\"#303030\" stroke-width=\"0.6\" stroke-opacity=\""
+                << edgeAlpha / 255.0 << "\" d=\"";
+            for (size_t i = first; i < std::min(edges.size(), first + edgesPerPath); ++i) {
+                const Point &a = points[edges[i].from], &b = points[edges[i].to];
+                out << 'M' << rounded(a.x) << ' ' << rounded(a.y) << 'L' << rounded(b.x) << ' ' << rounded(b.y);
+            }
+            out << "\"/>\n";
+            out.flushIfFull();
+        }
+
+        // Users sorted by department, so each department is one group
+        std::vector<uint32_t> byGroup(users);
+        for (uint32_t user = 0; user < users; ++user) {
+            byGroup[user] = user;
+        }
+        std::stable_sort(byGroup.begin(), byGroup.end(), [&](uint32_t a, uint32_t b) { return groups[a] < groups[b]; });
+        bool labelled = users <= options.maxLabels;
+        for (size_t i = 0; i < byGroup.size(); ++i) {
+            uint32_t user = byGroup[i];
+            if (i == 0 || groups[user] != groups[byGroup[i - 1]]) {
+                if (i > 0) {
+                    out << "</g>\n";
+                }
+                std::array<uint8_t, 3> color = groupColor(groups[user]);
+                out << "<g fill=\"#" << hexColor(color) << "\">\n";
+            }
+            const Point &p = points[user];
+            out << "<circle cx=\"" << rounded(p.x) << "\" cy=\"" << rounded(p.y) << "\" r=\"" << rounded(radius)
+                << "\"/>\n";
+            out.flushIfFull();
+        }
+        if (!byGroup.empty()) {
+            out << "</g>\n";
+        }
+        if (labelled) {
+            out << "<g font-family=\"sans-serif\" font-size=\"10\" fill=\"#000000\">\n";
+            for (uint32_t user = 0; user < users; ++user) {
+                out << "<text x=\"" << rounded(points[user].x + radius + 2) << "\" y=\"" << rounded(points[user].y + 3)
+                    << "\">";
+                escapeXml(out, graph.nameOf(user));
+                out << "</text>\n";
+            }
+            out << "</g>\n";
+        }
+        out << "</svg>\n";
+        record(stats, started);
+        return out.close();
+    }
+
+private:
+    struct Point {
+        float x, y;
+    };
+
+    struct Edge {
+        uint32_t from, to;
+    };
+
+    ImageOptions options;
+    ThreadPool &pool;
+    uint32_t users = 0;
+    std::vector<Edge> edges;        // each connection once, lower id first
+    std::vector<uint32_t> groups;   // user id -> department value id
+    std::vector<Point> points;      // user id -> pixel position
+    unsigned width = 0, height = 0;
+    float radius = 0;               // user disc radius in pixels
+    unsigned edgeAlpha = 255;
+    std::array<uint8_t, 256> edgeBlend; // channel value -> value with one connection drawn over it
+    unsigned tilesX = 0, tilesY = 0;
+    std::vector<uint8_t> pixels;    // RGB rows, top to bottom
+
+    static constexpr unsigned maxWidth = 16384;
+    static constexpr uint8_t edgeShade = 0x30;
+
+    // Bright, well separated colours: hues stepped by the golden angle
+    static std::array<uint8_t, 3> groupColor(uint32_t group) {
+        float hue = std::fmod(group * 0.618034f + 0.12f, 1.0f) * 6;
+        float saturation = 0.7f, value = 0.88f;
+        int sector = static_cast<int>(hue);
+        float f = hue - sector;
+        float p = value * (1 - saturation), q = value * (1 - saturation * f), t = value * (1 - saturation * (1 - f));
+        float rgb[6][3] = {{value, t, p}, {q, value, p}, {p, value, t}, {p, q, value}, {t, p, value}, {value, p, q}};
+        const float *c = rgb[sector % 6];
+        return {uint8_t(c[0] * 255), uint8_t(c[1] * 255), uint8_t(c[2] * 255)};
+    }
+
+    static std::string hexColor(const std::array<uint8_t, 3> &color) {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex;
+        for (uint8_t channel : color) {
+            hex += digits[channel >> 4];
+            hex += digits[channel & 15];
+        }
+        return hex;
+    }
+
+    static double rounded(float value) { return std::round(value * 10) / 10; }
+
+    static void escapeXml(OutputBuffer &out, std::string_view text) {
+        for (char c : text) {
+            switch (c) {
+            case '&': out << "&amp;"; break;
+            case '<': out << "&lt;"; break;
+            case '>': out << "&gt;"; break;
+            case '"': out << "&quot;"; break;
+            default: out << c;
+            }
+        }
+    }
+
+    // Bin everything into tiles (counting pass, then fill, like a CSR), then
+    // render the tiles in parallel
+    void rasterize() {
+        unsigned tile = std::max(options.tileSize, 16u);
+        tilesX = (width + tile - 1) / tile;
+        tilesY = (height + tile - 1) / tile;
+        size_t tileCount = size_t(tilesX) * tilesY;
+        pixels.assign(size_t(width) * height * 3, 255);
+
+        std::vector<uint32_t> edgeStart(tileCount + 1, 0), userStart(tileCount + 1, 0);
+        forEachEdgeTile([&](size_t t, uint32_t) { ++edgeStart[t + 1]; });
+        forEachUserTile([&](size_t t, uint32_t) { ++userStart[t + 1]; });
+        for (size_t t = 0; t < tileCount; ++t) {
+            edgeStart[t + 1] += edgeStart[t];
+            userStart[t + 1] += userStart[t];
+        }
+        std::vector<uint32_t> tileEdges(edgeStart[tileCount]), tileUsers(userStart[tileCount]);
+        std::vector<uint32_t> edgeFill(edgeStart.begin(), edgeStart.end() - 1);
+        std::vector<uint32_t> userFill(userStart.begin(), userStart.end() - 1);
+        forEachEdgeTile([&](size_t t, uint32_t edge) { tileEdges[edgeFill[t]++] = edge; });
+        forEachUserTile([&](size_t t, uint32_t user) { tileUsers[userFill[t]++] = user; });
+
+        pool.parallelFor(tileCount, 1, [&](size_t begin, size_t end, unsigned) {
+            for (size_t t = begin; t < end; ++t) {
+                int x0 = int(t % tilesX * tile), y0 = int(t / tilesX * tile);
+                int x1 = std::min<int>(x0 + tile, width), y1 = std::min<int>(y0 + tile, height);
+                for (uint32_t i = edgeStart[t]; i < edgeStart[t + 1]; ++i) {
+                    drawLine(points[edges[tileEdges[i]].from], points[edges[tileEdges[i]].to], x0, y0, x1, y1);
+                }
+                for (uint32_t i = userStart[t]; i < userStart[t + 1]; ++i) {
+                    drawDisc(tileUsers[i], x0, y0, x1, y1);
+                }
+            }
+        });
+    }
+
+    // visit(tile, edge) for every tile a connection's segment may cross:
+    // per tile column, the rows between the segment's ends within that
+    // column. Everything is widened by a pixel for the rounding in drawLine.
+    template <typename Visit>
+    void forEachEdgeTile(Visit visit) const {
+        float tile = static_cast<float>(std::max(options.tileSize, 16u));
+        for (uint32_t e = 0; e < edges.size(); ++e) {
+            Point a = points[edges[e].from], b = points[edges[e].to];
+            if (a.x > b.x) {
+                std::swap(a, b);
+            }
+            int firstColumn = std::clamp(int((a.x - 1) / tile), 0, int(tilesX) - 1);
+            int lastColumn = std::clamp(int((b.x + 1) / tile), 0, int(tilesX) - 1);
+            float slope = b.x > a.x ? (b.y - a.y) / (b.x - a.x) : 0;
+            for (int column = firstColumn; column <= lastColumn; ++column) {
+                float left = std::max(a.x, column * tile - 1), right = std::min(b.x, (column + 1) * tile + 1);
+                float yLeft = a.y + (left - a.x) * slope, yRight = a.y + (right - a.x) * slope;
+                if (b.x == a.x) {
+                    yLeft = a.y;
+                    yRight = b.y;
+                }
+                int firstRow = std::clamp(int((std::min(yLeft, yRight) - 1) / tile), 0, int(tilesY) - 1);
+                int lastRow = std::clamp(int((std::max(yLeft, yRight) + 1) / tile), 0, int(tilesY) - 1);
+                for (int row = firstRow; row <= lastRow; ++row) {
+                    visit(size_t(row) * tilesX + column, e);
+                }
+            }
+        }
+    }
+
+    template <typename Visit>
+    void forEachUserTile(Visit visit) const {
+        float tile = static_cast<float>(std::max(options.tileSize, 16u));
+        for (uint32_t user = 0; user < users; ++user) {
+            const Point &p = points[user];
+            int firstColumn = std::clamp(int((p.x - radius - 1) / tile), 0, int(tilesX) - 1);
+            int lastColumn = std::clamp(int((p.x + radius + 1) / tile), 0, int(tilesX) - 1);
+            int firstRow = std::clamp(int((p.y - radius - 1) / tile), 0, int(tilesY) - 1);
+            int lastRow = std::clamp(int((p.y + radius + 1) / tile), 0, int(tilesY) - 1);
+            for (int row = firstRow; row <= lastRow; ++row) {
+                for (int column = firstColumn; column <= lastColumn; ++column) {
+                    visit(size_t(row) * tilesX + column, user);
+                }
+            }
+        }
+    }
+
+    // One pixel per step along the major axis; the minor coordinate comes
+    // from the line equation in 32.32 fixed point (exact, so it does not
+    // depend on where the tile starts the line), and the major range is
+    // clipped to where the segment is inside the tile [x0, x1) x [y0, y1)
+    void drawLine(Point a, Point b, int x0, int y0, int x1, int y1) {
+        bool steep = std::fabs(b.y - a.y) > std::fabs(b.x - a.x);
+        if (steep) {
+            std::swap(a.x, a.y);
+            std::swap(b.x, b.y);
+            std::swap(x0, y0);
+            std::swap(x1, y1);
+        }
+        if (a.x > b.x) {
+            std::swap(a, b);
+        }
+        float slope = b.x > a.x ? (b.y - a.y) / (b.x - a.x) : 0;
+        float first = std::max(std::round(a.x), float(x0)), last = std::min(std::round(b.x), float(x1 - 1));
+        if (slope != 0) {
+            // Major coordinates where the minor one rounds into [y0, y1)
+            float enter = a.x + (y0 - 0.5f - a.y) / slope, leave = a.x + (y1 - 0.5f - a.y) / slope;
+            if (enter > leave) {
+                std::swap(enter, leave);
+            }
+            first = std::max(first, std::floor(enter));
+            last = std::min(last, std::ceil(leave));
+        }
+        if (first > last) {
+            return;
+        }
+        constexpr double one = 4294967296.0;
+        int64_t step = std::llround(double(slope) * one);
+        int64_t base = std::llround((double(a.y) + 0.5 - double(a.x) * slope) * one);
+        // Offsets of one step along each axis in the pixel array
+        size_t majorStride = steep ? size_t(width) * 3 : 3, minorStride = steep ? 3 : size_t(width) * 3;
+        for (int major = int(first); major <= int(last); ++major) {
+            int minor = int((base + major * step) >> 32);
+            if (minor < y0 || minor >= y1) {
+                continue;
+            }
+            uint8_t *pixel = &pixels[major * majorStride + minor * minorStride];
+            pixel[0] = edgeBlend[pixel[0]];
+            pixel[1] = edgeBlend[pixel[1]];
+            pixel[2] = edgeBlend[pixel[2]];
+        }
+    }
+
+    void drawDisc(uint32_t user, int x0, int y0, int x1, int y1) {
+        const Point &p = points[user];
+        std::array<uint8_t, 3> color = groupColor(groups[user]);
+        float reach = std::max(radius, 0.5f);
+        int left = std::max(x0, int(std::floor(p.x - reach))), right = std::min(x1 - 1, int(std::ceil(p.x + reach)));
+        int top = std::max(y0, int(std::floor(p.y - reach))), bottom = std::min(y1 - 1, int(std::ceil(p.y + reach)));
+        for (int y = top; y <= bottom; ++y) {
+            for (int x = left; x <= right; ++x) {
+                float dx = x + 0.5f - p.x, dy = y + 0.5f - p.y;
+                if (dx * dx + dy * dy <= reach * reach || (x == int(p.x) && y == int(p.y))) {
+                    std::copy(color.begin(), color.end(), &pixels[(size_t(y) * width + x) * 3]);
+                }
+            }
+        }
+    }
+
+    static void putBigEndian(std::string &out, uint32_t value) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            out += char(value >> shift & 0xFF);
+        }
+    }
+
+    static uint32_t crc32(std::string_view type, std::string_view data) {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> entries{};
+            for (uint32_t n = 0; n < 256; ++n) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k) {
+                    c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                entries[n] = c;
+            }
+            return entries;
+        }();
+        uint32_t crc = 0xFFFFFFFFu;
+        for (std::string_view part : {type, data}) {
+            for (char c : part) {
+                crc = table[(crc ^ uint8_t(c)) & 0xFF] ^ (crc >> 8);
+            }
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    static void writeChunk(OutputBuffer &out, std::string_view type, const std::string &data) {
+        std::string header;
+        putBigEndian(header, static_cast<uint32_t>(data.size()));
+        header += type;
+        std::string trailer;
+        putBigEndian(trailer, crc32(type, data));
+        out.write(header);
+        out.write(data);
+        out.write(trailer);
+    }
+
+    // Writes deflate codes least significant bit first
+    struct BitWriter {
+        std::string bytes;
+        uint64_t bits = 0;
+        int count = 0;
+
+        void put(uint32_t value, int length) {
+            bits |= uint64_t(value) << count;
+            count += length;
+            while (count >= 8) {
+                bytes += char(bits & 0xFF);
+                bits >>= 8;
+                count -= 8;
+            }
+        }
+
+        // Huffman codes are defined most significant bit first
+        void putCode(uint32_t code, int length) {
+            uint32_t reversed = 0;
+            for (int i = 0; i < length; ++i) {
+                reversed |= (code >> i & 1) << (length - 1 - i);
+            }
+            put(reversed, length);
+        }
+
+        void literal(unsigned symbol) {
+            if (symbol < 144) {
+                putCode(0x30 + symbol, 8);
+            } else if (symbol < 256) {
+                putCode(0x190 + symbol - 144, 9);
+            } else if (symbol < 280) {
+                putCode(symbol - 256, 7);
+            } else {
+                putCode(0xC0 + symbol - 280, 8);
+            }
+        }
+
+        void finish() {
+            if (count > 0) {
+                bytes += char(bits & 0xFF);
+            }
+            bits = 0;
+            count = 0;
+        }
+    };
+
+    // zlib stream of the Sub-filtered rows: one fixed-Huffman block of
+    // literals and distance-1 matches
+    std::string deflatePixels() const {
+        static constexpr uint16_t lengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                                    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static constexpr uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        size_t stride = size_t(width) * 3;
+        std::string filtered;
+        filtered.reserve((stride + 1) * height);
+        for (unsigned y = 0; y < height; ++y) {
+            const uint8_t *row = &pixels[y * stride];
+            filtered += char(1); // Sub: each byte minus the same channel of the pixel to its left
+            for (size_t i = 0; i < stride; ++i) {
+                filtered += char(row[i] - (i >= 3 ? row[i - 3] : 0));
+            }
+        }
+
+        uint32_t a = 1, b = 0; // Adler-32
+        for (size_t i = 0; i < filtered.size(); ++i) {
+            a = (a + uint8_t(filtered[i])) % 65521;
+            b = (b + a) % 65521;
+        }
+
+        BitWriter stream;
+        stream.bytes = std::string("\x78\x01", 2);
+        stream.put(1, 1); // final block
+        stream.put(1, 2); // fixed Huffman codes
+        size_t i = 0;
+        while (i < filtered.size()) {
+            size_t run = 0;
+            while (i > 0 && i + run < filtered.size() && run < 258 && filtered[i + run] == filtered[i - 1]) {
+                ++run;
+            }
+            if (run < 3) {
+                stream.literal(uint8_t(filtered[i++]));
+                continue;
+            }
+            int code = int(std::upper_bound(lengthBase, lengthBase + 29, run) - lengthBase) - 1;
+            stream.literal(257 + code);
+            stream.put(uint32_t(run - lengthBase[code]), lengthExtra[code]);
+            stream.putCode(0, 5); // distance 1
+            i += run;
+        }
+        stream.literal(256);
+        stream.finish();
+        putBigEndian(stream.bytes, b << 16 | a);
+        return stream.bytes;
+    }
+
+    void record(ImageStats *stats, std::chrono::steady_clock::time_point started) const {
+        if (stats != nullptr) {
+            stats->users = users;
+            stats->edges = edges.size();
+            stats->width = width;
+            stats->height = height;
+            stats->tiles = size_t(tilesX) * tilesY;
+            stats->threads = pool.size();
+            stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        }
+    }
+};
+
+// Render `graph` with `layout` to `path`; the format follows the extension
+// (.svg, .png, anything else is PPM)
+inline bool writeNetworkImage(const std::string &path, const GraphView &graph, const std::vector<LayoutPoint> &layout,
+                              const std::vector<uint32_t> &groupOf, const ImageOptions &options,
+                              ImageStats *stats = nullptr) {
+    auto started = std::chrono::steady_clock::now();
+    NetworkImage image(options);
+    image.setScene(graph, layout, groupOf);
+    auto endsWith = [&](std::string_view suffix) {
+        return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    bool written = endsWith(".svg")   ? image.writeSVG(path, graph, stats)
+                   : endsWith(".png") ? image.writePNG(path, stats)
+                                      : image.writePPM(path, stats);
+    if (stats != nullptr) {
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+    return written;
+}
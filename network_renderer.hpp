@@ -0,0 +1,360 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "graph_view.hpp"
+
+// Retained-mode network viewer.
+//
+// The scene is turned into GPU-friendly arrays once, when it is set:
+//   - every connection is two vertices of one sf::Lines vertex array, drawn
+//     with a single call
+//   - every user is a textured quad (a disc texture tinted by the vertex
+//     colour), so all visible users are again a single draw call
+//   - users are bucketed into a uniform grid, so a frame only looks at the
+//     grid cells the view overlaps (viewport culling)
+// Labels use one font loaded once per process. They are created the first
+// time their user is labelled, drawn in screen space (crisp at any zoom) and
+// only shown when users are large enough on screen and few enough are
+// visible to read them (level of detail).
+//
+// Nothing is redrawn unless something changed: the loop sleeps in
+// waitEvent() and only renders after an event that moved the view, resized
+// the window or exposed it again.
+//
+// Controls: drag or arrow keys to pan, mouse wheel or +/- to zoom,
+// R to fit the whole network, Escape to close.
+class NetworkRenderer {
+public:
+    static constexpr float nodeRadius = 20.0f;     // world units
+    static constexpr float minNodePixels = 2.0f;   // users never shrink below this on screen
+    static constexpr float labelMinPixels = 6.0f;  // node radius on screen from which labels appear
+    static constexpr size_t maxLabels = 1500;      // more visible users than this: no labels
+    static constexpr unsigned labelSize = 12;
+
+    NetworkRenderer() { buildDiscTexture(); }
+
+    // Replace the scene: the network and a position per user. Names are
+    // read through the view when labels are made, so the network must not
+    // change while the scene is shown.
+    void setScene(const GraphView &graph, std::vector<sf::Vector2f> userPositions) {
+        network = graph;
+        positions = std::move(userPositions);
+        labels.clear();
+        labels.resize(positions.size());
+
+        // Dense graphs turn into a white sheet at full opacity
+        size_t connections = graph.connectionCount();
+        sf::Color edgeColor(255, 255, 255, connections > 20000 ? 48 : connections > 2000 ? 120 : 255);
+        edgeLines.setPrimitiveType(sf::Lines);
+        edgeLines.resize(connections * 2);
+        size_t vertex = 0;
+        graph.forEachConnection([&](uint32_t user, uint32_t conn) {
+            edgeLines[vertex++] = sf::Vertex(positions[user], edgeColor);
+            edgeLines[vertex++] = sf::Vertex(positions[conn], edgeColor);
+        });
+        buildGrid();
+        needsFit = true;
+        dirty = true;
+    }
+
+    // Open a window and show the scene until the window is closed
+    void run(const std::string &title, unsigned width = 800, unsigned height = 600) {
+        sf::RenderWindow window(sf::VideoMode(width, height), title);
+        screen = sf::View(sf::FloatRect(0, 0, float(width), float(height)));
+        if (needsFit) {
+            fitView(window.getSize());
+        }
+
+        bool dragging = false;
+        sf::Vector2i dragFrom;
+        sf::Event event;
+        while (window.isOpen()) {
+            if (dirty) {
+                draw(window);
+                dirty = false;
+            }
+            if (!window.waitEvent(event)) {
+                break;
+            }
+            do {
+                handle(event, window, dragging, dragFrom);
+            } while (window.isOpen() && window.pollEvent(event));
+        }
+    }
+
+private:
+    std::optional<GraphView> network;
+    std::vector<sf::Vector2f> positions;
+    std::vector<std::unique_ptr<sf::Text>> labels; // created the first time a user is labelled
+    sf::VertexArray edgeLines;
+    sf::VertexArray nodeQuads;                      // visible users, refilled per frame
+    std::vector<uint32_t> visibleUsers;
+    sf::Texture disc;
+    sf::View view;   // world coordinates
+    sf::View screen; // pixel coordinates, for labels
+    bool dirty = true;
+    bool needsFit = true;
+
+    // Uniform grid over the scene bounds: users of cell c are
+    // cellUsers[cellStart[c] .. cellStart[c + 1])
+    sf::FloatRect bounds;
+    float cellSize = 1;
+    uint32_t gridWidth = 0, gridHeight = 0;
+    std::vector<uint32_t> cellStart, cellUsers;
+
+    // Loaded on first use and kept for the life of the process; nullptr if
+    // the font file is missing (the viewer then runs without labels)
+    static const sf::Font *labelFont() {
+        static std::unique_ptr<sf::Font> font;
+        static bool loaded = false;
+        if (!loaded) {
+            loaded = true;
+            font = std::make_unique<sf::Font>();
+            if (!font->loadFromFile("arial.ttf")) {
+                std::cerr << "Error loading font!\n";
+                font.reset();
+            }
+        }
+        return font.get();
+    }
+
+    // White anti-aliased disc; quads sample it and tint it with their colour
+    void buildDiscTexture() {
+        const unsigned size = 64;
+        sf::Image image;
+        image.create(size, size, sf::Color::Transparent);
+        float radius = size / 2.0f;
+        for (unsigned y = 0; y < size; ++y) {
+            for (unsigned x = 0; x < size; ++x) {
+                float dx = x + 0.5f - radius, dy = y + 0.5f - radius;
+                float coverage = std::clamp(radius - std::sqrt(dx * dx + dy * dy), 0.0f, 1.0f);
+                image.setPixel(x, y, sf::Color(255, 255, 255, static_cast<sf::Uint8>(coverage * 255)));
+            }
+        }
+        disc.loadFromImage(image);
+        disc.setSmooth(true);
+    }
+
+    void buildGrid() {
+        float left = 0, top = 0, right = 0, bottom = 0;
+        if (!positions.empty()) {
+            left = right = positions[0].x;
+            top = bottom = positions[0].y;
+        }
+        for (const sf::Vector2f &p : positions) {
+            left = std::min(left, p.x);
+            right = std::max(right, p.x);
+            top = std::min(top, p.y);
+            bottom = std::max(bottom, p.y);
+        }
+        bounds = sf::FloatRect(left, top, right - left, bottom - top);
+
+        // About four users per cell on average
+        float area = std::max(bounds.width, 1.0f) * std::max(bounds.height, 1.0f);
+        cellSize = std::max(std::sqrt(area * 4 / std::max<size_t>(positions.size(), 1)), nodeRadius);
+        gridWidth = static_cast<uint32_t>(bounds.width / cellSize) + 1;
+        gridHeight = static_cast<uint32_t>(bounds.height / cellSize) + 1;
+
+        cellStart.assign(size_t(gridWidth) * gridHeight + 1, 0);
+        std::vector<uint32_t> cellOf(positions.size());
+        for (size_t user = 0; user < positions.size(); ++user) {
+            cellOf[user] = cellIndex(positions[user]);
+            ++cellStart[cellOf[user] + 1];
+        }
+        for (size_t c = 1; c < cellStart.size(); ++c) {
+            cellStart[c] += cellStart[c - 1];
+        }
+        cellUsers.resize(positions.size());
+        std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+        for (size_t user = 0; user < positions.size(); ++user) {
+            cellUsers[fill[cellOf[user]]++] = static_cast<uint32_t>(user);
+        }
+    }
+
+    uint32_t cellIndex(sf::Vector2f p) const {
+        uint32_t cx = std::min(gridWidth - 1, static_cast<uint32_t>(std::max(0.0f, (p.x - bounds.left) / cellSize)));
+        uint32_t cy = std::min(gridHeight - 1, static_cast<uint32_t>(std::max(0.0f, (p.y - bounds.top) / cellSize)));
+        return cy * gridWidth + cx;
+    }
+
+    // Users whose position lies in `area`, into visibleUsers
+    void collectVisible(const sf::FloatRect &area) {
+        visibleUsers.clear();
+        if (positions.empty()) {
+            return;
+        }
+        auto cellRange = [&](float low, float high, float origin, uint32_t cells) {
+            float first = std::floor((low - origin) / cellSize), last = std::floor((high - origin) / cellSize);
+            return std::make_pair(static_cast<uint32_t>(std::clamp(first, 0.0f, float(cells - 1))),
+                                  static_cast<uint32_t>(std::clamp(last, 0.0f, float(cells - 1))));
+        };
+        auto [x0, x1] = cellRange(area.left, area.left + area.width, bounds.left, gridWidth);
+        auto [y0, y1] = cellRange(area.top, area.top + area.height, bounds.top, gridHeight);
+        for (uint32_t cy = y0; cy <= y1; ++cy) {
+            for (uint32_t cx = x0; cx <= x1; ++cx) {
+                size_t cell = size_t(cy) * gridWidth + cx;
+                for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+                    const sf::Vector2f &p = positions[cellUsers[i]];
+                    if (area.contains(p.x, p.y)) {
+                        visibleUsers.push_back(cellUsers[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Show the whole network with a margin of one node
+    void fitView(sf::Vector2u windowSize) {
+        float width = bounds.width + 4 * nodeRadius, height = bounds.height + 4 * nodeRadius;
+        float scale = std::max(width / windowSize.x, height / windowSize.y);
+        view.setCenter(bounds.left + bounds.width / 2, bounds.top + bounds.height / 2);
+        view.setSize(windowSize.x * scale, windowSize.y * scale);
+        needsFit = false;
+    }
+
+    // Zoom by `factor` (< 1 zooms in) keeping the point under `pixel` in place
+    void zoomAt(const sf::RenderWindow &window, sf::Vector2i pixel, float factor) {
+        sf::Vector2f before = window.mapPixelToCoords(pixel, view);
+        view.zoom(factor);
+        sf::Vector2f after = window.mapPixelToCoords(pixel, view);
+        view.move(before - after);
+    }
+
+    void handle(const sf::Event &event, sf::RenderWindow &window, bool &dragging, sf::Vector2i &dragFrom) {
+        sf::Vector2u size = window.getSize();
+        sf::Vector2i middle(size.x / 2, size.y / 2);
+        float panStep = view.getSize().x / 10;
+        switch (event.type) {
+        case sf::Event::Closed:
+            window.close();
+            break;
+        case sf::Event::Resized: {
+            // Keep the scale: the view grows and shrinks with the window
+            float unitsPerPixel = view.getSize().x / screen.getSize().x;
+            view.setSize(event.size.width * unitsPerPixel, event.size.height * unitsPerPixel);
+            screen = sf::View(sf::FloatRect(0, 0, float(event.size.width), float(event.size.height)));
+            dirty = true;
+            break;
+        }
+        case sf::Event::GainedFocus:
+            dirty = true;
+            break;
+        case sf::Event::MouseWheelScrolled:
+            zoomAt(window, {event.mouseWheelScroll.x, event.mouseWheelScroll.y},
+                   event.mouseWheelScroll.delta > 0 ? 0.8f : 1.25f);
+            dirty = true;
+            break;
+        case sf::Event::MouseButtonPressed:
+            if (event.mouseButton.button == sf::Mouse::Left) {
+                dragging = true;
+                dragFrom = {event.mouseButton.x, event.mouseButton.y};
+            }
+            break;
+        case sf::Event::MouseButtonReleased:
+            if (event.mouseButton.button == sf::Mouse::Left) {
+                dragging = false;
+            }
+            break;
+        case sf::Event::MouseMoved:
+            if (dragging) {
+                sf::Vector2i to(event.mouseMove.x, event.mouseMove.y);
+                view.move(window.mapPixelToCoords(dragFrom, view) - window.mapPixelToCoords(to, view));
+                dragFrom = to;
+                dirty = true;
+            }
+            break;
+        case sf::Event::TextEntered:
+            if (event.text.unicode == '+' || event.text.unicode == '=') {
+                zoomAt(window, middle, 0.8f);
+                dirty = true;
+            } else if (event.text.unicode == '-') {
+                zoomAt(window, middle, 1.25f);
+                dirty = true;
+            } else if (event.text.unicode == 'r' || event.text.unicode == 'R') {
+                fitView(size);
+                dirty = true;
+            }
+            break;
+        case sf::Event::KeyPressed:
+            switch (event.key.code) {
+            case sf::Keyboard::Escape:
+                window.close();
+                break;
+            case sf::Keyboard::Left:
+                view.move(-panStep, 0);
+                dirty = true;
+                break;
+            case sf::Keyboard::Right:
+                view.move(panStep, 0);
+                dirty = true;
+                break;
+            case sf::Keyboard::Up:
+                view.move(0, -panStep);
+                dirty = true;
+                break;
+            case sf::Keyboard::Down:
+                view.move(0, panStep);
+                dirty = true;
+                break;
+            default:
+                break;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    void draw(sf::RenderWindow &window) {
+        window.clear(sf::Color::Black);
+        window.setView(view);
+        window.draw(edgeLines);
+
+        sf::Vector2f center = view.getCenter(), extent = view.getSize();
+        float pixelsPerUnit = screen.getSize().x / extent.x;
+        float half = std::max(nodeRadius, minNodePixels / pixelsPerUnit);
+        collectVisible(sf::FloatRect(center.x - extent.x / 2 - half, center.y - extent.y / 2 - half,
+                                     extent.x + 2 * half, extent.y + 2 * half));
+
+        sf::Vector2f textureSize(disc.getSize());
+        nodeQuads.setPrimitiveType(sf::Quads);
+        nodeQuads.resize(visibleUsers.size() * 4);
+        for (size_t i = 0; i < visibleUsers.size(); ++i) {
+            sf::Vector2f p = positions[visibleUsers[i]];
+            nodeQuads[4 * i] = sf::Vertex({p.x - half, p.y - half}, sf::Color::Blue, {0, 0});
+            nodeQuads[4 * i + 1] = sf::Vertex({p.x + half, p.y - half}, sf::Color::Blue, {textureSize.x, 0});
+            nodeQuads[4 * i + 2] = sf::Vertex({p.x + half, p.y + half}, sf::Color::Blue, textureSize);
+            nodeQuads[4 * i + 3] = sf::Vertex({p.x - half, p.y + half}, sf::Color::Blue, {0, textureSize.y});
+        }
+        sf::RenderStates states;
+        states.texture = &disc;
+        window.draw(nodeQuads, states);
+
+        const sf::Font *font = labelFont();
+        if (font != nullptr && nodeRadius * pixelsPerUnit >= labelMinPixels && visibleUsers.size() <= maxLabels) {
+            window.setView(screen);
+            for (uint32_t user : visibleUsers) {
+                std::unique_ptr<sf::Text> &label = labels[user];
+                if (!label) {
+                    label = std::make_unique<sf::Text>(network->nameOf(user), *font, labelSize);
+                    label->setFillColor(sf::Color::White);
+                }
+                sf::Vector2f corner(positions[user].x - 15, positions[user].y - 15);
+                label->setPosition(sf::Vector2f(window.mapCoordsToPixel(corner, view)));
+                window.draw(*label);
+            }
+        }
+        window.display();
+    }
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "attribute_index.hpp"
+#include "graph_core.hpp"
+#include "graph_view.hpp"
+#include "output_buffer.hpp"
+
+// Text reports shared by the menu programs and timed by the benchmark: the
+// attribute listings and the whole-network DOT export. Both only format into
+// an OutputBuffer, so the caller decides where the text goes.
+
+// One "--- title ---" listing: every user as "name (detail)", or
+// `emptyMessage` when there are none
+inline void writeUserListing(OutputBuffer &out, std::string_view title, const std::vector<uint32_t> &users,
+                             const GraphCore &graph, const AttributeIndex &detail, std::string_view emptyMessage) {
+    out << "\n--- " << title << " ---\n";
+    for (uint32_t user : users) {
+        out << graph.nameOf(user) << " (" << detail.valueOf(user) << ")\n";
+        out.flushIfFull();
+    }
+    if (users.empty()) {
+        out << emptyMessage << "\n";
+    }
+    out << "--------------------------------\n";
+}
+
+// Every connection as an undirected Graphviz edge
+inline void writeDotGraph(OutputBuffer &out, const GraphView &network) {
+    out << "graph NetworkGraph {\n";
+    network.forEachConnection([&](uint32_t user, uint32_t conn) {
+        out << "  \"" << network.nameOf(user) << "\" -- \"" << network.nameOf(conn) << "\";\n";
+        out.flushIfFull();
+    });
+    out << "}\n";
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Text output for every printer and exporter.
+//
+// Text is formatted into one large reusable buffer (numbers with
+// std::to_chars: no locale, no stream state, no per-call locking) and handed
+// to the kernel with write(2) only when the caller says so:
+//   - flushIfFull() at record boundaries (after a line, a DOT statement, ...)
+//     drains the buffer once it holds `capacity` bytes
+//   - flush() drains it unconditionally (end of a report or file)
+// so a dump costs one system call per `capacity` bytes. write() takes a
+// complete block at a record boundary; large blocks are not copied but go
+// out together with the pending bytes in a single writev(2).
+// Without a file descriptor the buffer only accumulates, which is how
+// results are rendered into strings (see text()).
+class OutputBuffer {
+public:
+    static constexpr size_t defaultCapacity = 1 << 20;
+
+    // In-memory buffer: nothing is ever written
+    OutputBuffer() = default;
+
+    // Write to an open descriptor, which stays open
+    explicit OutputBuffer(int fd, size_t capacity = defaultCapacity) : fd(fd), capacity(capacity) {
+        buffer.reserve(capacity);
+    }
+
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    ~OutputBuffer() { close(); }
+
+    // Create or truncate `path` and write to it; false if it cannot be opened
+    bool open(const std::string &path) {
+        close();
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        owned = fd >= 0;
+        failed = false;
+        buffer.reserve(capacity);
+        return owned;
+    }
+
+    // Flush, and close the descriptor if open() opened it; false if any write failed
+    bool close() {
+        flush();
+        if (owned) {
+            failed = ::close(fd) != 0 || failed;
+            owned = false;
+            fd = -1;
+        }
+        return !failed;
+    }
+
+    bool good() const { return !failed; }
+
+    OutputBuffer &operator<<(std::string_view text) {
+        buffer += text;
+        return *this;
+    }
+
+    OutputBuffer &operator<<(const std::string &text) { return *this << std::string_view(text); }
+
+    OutputBuffer &operator<<(const char *text) { return *this << std::string_view(text); }
+
+    OutputBuffer &operator<<(char c) {
+        buffer += c;
+        return *this;
+    }
+
+    template <typename Integer, std::enable_if_t<std::is_integral_v<Integer> && !std::is_same_v<Integer, char> &&
+                                                     !std::is_same_v<Integer, bool>,
+                                                 int> = 0>
+    OutputBuffer &operator<<(Integer value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr);
+        return *this;
+    }
+
+    // Same digits as an ostream with default settings (%g, 6 significant digits)
+    OutputBuffer &operator<<(double value) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, 6);
+        buffer.append(digits, result.ptr);
+        return *this;
+    }
+
+    // Append a complete block at a record boundary
+    void write(std::string_view block) {
+        if (fd < 0 || block.size() < capacity / 4) {
+            buffer += block;
+            flushIfFull();
+            return;
+        }
+        iovec parts[2] = {{buffer.data(), buffer.size()}, {const_cast<char *>(block.data()), block.size()}};
+        writeAll(parts, 2);
+        buffer.clear();
+    }
+
+    void flushIfFull() {
+        if (buffer.size() >= capacity) {
+            flush();
+        }
+    }
+
+    // Hand everything buffered to the descriptor; the buffer is kept for reuse.
+    // Text already written to standard output through stdio or std::cout is
+    // flushed first, so the two never come out of order.
+    void flush() {
+        if (fd < 0 || buffer.empty()) {
+            return;
+        }
+        iovec part = {buffer.data(), buffer.size()};
+        writeAll(&part, 1);
+        buffer.clear();
+    }
+
+    // Text buffered and not yet written (everything, for an in-memory buffer)
+    std::string_view text() const { return buffer; }
+
+    size_t size() const { return buffer.size(); }
+
+    void clear() { buffer.clear(); }
+
+private:
+    int fd = -1;
+    bool owned = false;
+    bool failed = false;
+    size_t capacity = defaultCapacity;
+    std::string buffer;
+
+    void writeAll(iovec *parts, int count) {
+        if (fd == STDOUT_FILENO) {
+            std::fflush(stdout);
+        }
+        while (count > 0 && !failed) {
+            ssize_t written = ::writev(fd, parts, count);
+            if (written < 0) {
+                failed = errno != EINTR;
+                continue;
+            }
+            while (count > 0 && size_t(written) >= parts->iov_len) {
+                written -= parts->iov_len;
+                ++parts;
+                --count;
+            }
+            if (count > 0) {
+                parts->iov_base = static_cast<char *>(parts->iov_base) + written;
+                parts->iov_len -= written;
+            }
+        }
+    }
+};
+
+// Shared buffer on standard output for the menu printers. Printers append
+// and call flushIfFull() per record; the menu flushes once per command, and
+// the buffer drains itself at exit.
+inline OutputBuffer &standardOutput() {
+    static OutputBuffer out(STDOUT_FILENO);
+    return out;
+}
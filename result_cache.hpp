@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// LRU cache of rendered query results with fine-grained invalidation.
+//
+// Every mutation touches the parts of the network it changed: the adjacency
+// rows of the two users it connects, the connected component they are in,
+// the attribute values it assigns. Touching stamps that part with the next
+// value of a global clock. A cached result remembers which parts it was
+// computed from and the clock value when it was stored, and is served only
+// while none of them has been touched since. Results that depend on other
+// parts of the network are unaffected by a mutation.
+struct CacheDependency {
+    enum Kind : uint8_t {
+        Adjacency, // id: user whose neighbour list was read
+        Component, // id: component representative (GraphCore::componentOf) at compute time
+        Attribute  // id: attributeKey() of an attribute value, or of a whole attribute
+    };
+
+    Kind kind;
+    uint64_t id;
+};
+
+// Attribute dependency ids. A colliding hash only expires extra entries.
+inline uint64_t attributeKey(std::string_view attribute) { return std::hash<std::string_view>()(attribute); }
+
+inline uint64_t attributeKey(std::string_view attribute, std::string_view value) {
+    std::string text(attribute);
+    text += '\0';
+    text += value;
+    return std::hash<std::string>()(text) ^ 1;
+}
+
+class ResultCache {
+public:
+    // Least recently used results are evicted once the entries (text, key and
+    // dependency list) take more than `byteBudget` bytes
+    explicit ResultCache(size_t byteBudget = 64 << 20) : budget(byteBudget) {}
+
+    // Record a change: results depending on it are no longer served
+    void touch(CacheDependency dependency) {
+        uint64_t now = ++clock;
+        if (dependency.kind == CacheDependency::Attribute) {
+            attributeVersions[dependency.id] = now;
+            return;
+        }
+        std::vector<uint64_t> &versions = dependency.kind == CacheDependency::Adjacency ? userVersions
+                                                                                          : componentVersions;
+        if (versions.size() <= dependency.id) {
+            versions.resize(dependency.id + 1, 0);
+        }
+        versions[dependency.id] = now;
+    }
+
+    // Cached result for `key`; nullptr on a miss. A stale entry is dropped.
+    const std::string *find(const std::string &key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            ++missCount;
+            return nullptr;
+        }
+        Entry &entry = *it->second;
+        for (const CacheDependency &dependency : entry.dependencies) {
+            if (versionOf(dependency) > entry.stamp) {
+                erase(it->second);
+                ++staleCount;
+                ++missCount;
+                return nullptr;
+            }
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        ++hitCount;
+        return &entry.result;
+    }
+
+    // Store a result just computed from `dependencies`; returns the stored text
+    const std::string &insert(const std::string &key, std::string result,
+                              std::vector<CacheDependency> dependencies) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            erase(it->second);
+        }
+        entries.push_front({key, std::move(result), std::move(dependencies), clock});
+        Entry &entry = entries.front();
+        entry.bytes = sizeof(Entry) + entry.key.size() * 2 + entry.result.size() +
+                      entry.dependencies.size() * sizeof(CacheDependency);
+        index.emplace(entry.key, entries.begin());
+        used += entry.bytes;
+        while (used > budget && entries.size() > 1) {
+            erase(std::prev(entries.end()));
+        }
+        return entry.result;
+    }
+
+    // Drop every entry (after changes too large to track one by one)
+    void clear() {
+        entries.clear();
+        index.clear();
+        used = 0;
+    }
+
+    uint64_t hits() const { return hitCount; }
+    uint64_t misses() const { return missCount; }
+    uint64_t staleDrops() const { return staleCount; } // misses caused by an invalidated entry
+    size_t size() const { return entries.size(); }
+    size_t bytes() const { return used; }
+
+private:
+    struct Entry {
+        std::string key;
+        std::string result;
+        std::vector<CacheDependency> dependencies;
+        uint64_t stamp; // clock value when the result was computed
+        size_t bytes = 0;
+    };
+
+    size_t budget;
+    size_t used = 0;
+    uint64_t clock = 0;
+    uint64_t hitCount = 0, missCount = 0, staleCount = 0;
+    std::list<Entry> entries; // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    std::vector<uint64_t> userVersions;      // last touch per user adjacency row
+    std::vector<uint64_t> componentVersions; // last touch per component representative
+    std::unordered_map<uint64_t, uint64_t> attributeVersions;
+
+    uint64_t versionOf(const CacheDependency &dependency) const {
+        if (dependency.kind == CacheDependency::Attribute) {
+            auto it = attributeVersions.find(dependency.id);
+            return it == attributeVersions.end() ? 0 : it->second;
+        }
+        const std::vector<uint64_t> &versions =
+            dependency.kind == CacheDependency::Adjacency ? userVersions : componentVersions;
+        return dependency.id < versions.size() ? versions[dependency.id] : 0;
+    }
+
+    void erase(std::list<Entry>::iterator it) {
+        used -= it->bytes;
+        index.erase(it->key);
+        entries.erase(it);
+    }
+};
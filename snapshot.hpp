@@ -0,0 +1,371 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "attribute_index.hpp"
+#include "graph_core.hpp"
+#include "mapped_file.hpp"
+
+// Binary network snapshot.
+//
+// Layout: SnapshotHeader, then `sectionCount` SnapshotSection entries, then
+// the section payloads, each starting on an 8-byte boundary. Every array is
+// stored exactly as it sits in memory, so loading maps the file and copies
+// the payloads instead of parsing text.
+constexpr char snapshotMagic[8] = {'S', 'N', 'E', 'T', 'S', 'N', 'A', 'P'};
+constexpr uint32_t snapshotVersion = 2;
+
+enum SnapshotSectionKind : uint32_t {
+    SectionNameOffsets = 1,       // uint64[userCount + 1] into SectionNameBytes
+    SectionNameBytes = 2,         // concatenated usernames
+    SectionAttributeName = 3,     // attribute label, e.g. "department"
+    SectionValueOffsets = 4,      // uint64[valueCount + 1] into SectionValueBytes
+    SectionValueBytes = 5,        // concatenated attribute values
+    SectionUserValues = 6,        // uint32[userCount] value id per user
+    SectionRowOffsets = 7,        // uint64[userCount + 1] CSR row offsets
+    SectionAdjacency = 8,         // uint32[rowOffsets[userCount]] CSR neighbour ids
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t sectionCount;
+    uint64_t userCount;
+    uint64_t attributeCount;
+    uint64_t logSequence; // last write-ahead log record folded into this snapshot
+};
+
+struct SnapshotSection {
+    uint32_t kind;
+    uint32_t attribute; // attribute slot for kinds 3-6, otherwise 0
+    uint64_t offset;    // from the start of the file
+    uint64_t size;      // in bytes
+};
+
+// Named attribute tables that travel with the graph
+using SnapshotAttributes = std::vector<std::pair<std::string, const AttributeIndex *>>;
+using SnapshotAttributeTargets = std::vector<std::pair<std::string, AttributeIndex *>>;
+
+// Self-contained copy of everything a snapshot holds, ready to be written
+struct SnapshotImage {
+    struct Attribute {
+        std::string name;
+        std::vector<uint64_t> valueOffsets{0};
+        std::string valueBytes;
+        std::vector<uint32_t> userValues;
+    };
+
+    uint64_t userCount = 0;
+    uint64_t logSequence = 0;
+    std::vector<uint64_t> nameOffsets{0};
+    std::string nameBytes;
+    std::vector<Attribute> attributes;
+    std::vector<uint64_t> rowOffsets;
+    std::vector<uint32_t> adjacency;
+};
+
+inline SnapshotImage captureSnapshot(const GraphCore &graph, const SnapshotAttributes &attributes) {
+    SnapshotImage image;
+    image.userCount = graph.userCount();
+    for (uint32_t user = 0; user < graph.userCount(); ++user) {
+        image.nameBytes += graph.nameOf(user);
+        image.nameOffsets.push_back(image.nameBytes.size());
+    }
+    for (const auto &[name, index] : attributes) {
+        SnapshotImage::Attribute attribute;
+        attribute.name = name;
+        for (uint32_t value = 0; value < index->valueCount(); ++value) {
+            attribute.valueBytes += index->valueName(value);
+            attribute.valueOffsets.push_back(attribute.valueBytes.size());
+        }
+        attribute.userValues = index->userValueIds();
+        image.attributes.push_back(std::move(attribute));
+    }
+    image.rowOffsets = graph.rowOffsets();
+    image.adjacency = graph.adjacency();
+    return image;
+}
+
+// fsync a file, or with `directory` a directory (which makes a rename or
+// removal of one of its entries durable)
+inline bool syncToDisk(const std::string &path, bool directory = false) {
+    int fd = ::open(path.c_str(), directory ? O_RDONLY | O_DIRECTORY : O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+
+inline std::string parentDirectory(const std::string &path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+}
+
+// Write the image to `path` atomically (temporary file + rename), durably
+inline bool writeSnapshot(const std::string &path, const SnapshotImage &image) {
+    struct Payload {
+        SnapshotSection section;
+        const void *data;
+    };
+    std::vector<Payload> payloads;
+    auto add = [&](uint32_t kind, uint32_t attribute, const void *data, uint64_t size) {
+        payloads.push_back({{kind, attribute, 0, size}, data});
+    };
+    add(SectionNameOffsets, 0, image.nameOffsets.data(), image.nameOffsets.size() * sizeof(uint64_t));
+    add(SectionNameBytes, 0, image.nameBytes.data(), image.nameBytes.size());
+    for (uint32_t a = 0; a < image.attributes.size(); ++a) {
+        const SnapshotImage::Attribute &attribute = image.attributes[a];
+        add(SectionAttributeName, a, attribute.name.data(), attribute.name.size());
+        add(SectionValueOffsets, a, attribute.valueOffsets.data(), attribute.valueOffsets.size() * sizeof(uint64_t));
+        add(SectionValueBytes, a, attribute.valueBytes.data(), attribute.valueBytes.size());
+        add(SectionUserValues, a, attribute.userValues.data(), attribute.userValues.size() * sizeof(uint32_t));
+    }
+    add(SectionRowOffsets, 0, image.rowOffsets.data(), image.rowOffsets.size() * sizeof(uint64_t));
+    add(SectionAdjacency, 0, image.adjacency.data(), image.adjacency.size() * sizeof(uint32_t));
+
+    SnapshotHeader header{};
+    memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+    header.version = snapshotVersion;
+    header.sectionCount = static_cast<uint32_t>(payloads.size());
+    header.userCount = image.userCount;
+    header.attributeCount = image.attributes.size();
+    header.logSequence = image.logSequence;
+
+    uint64_t offset = sizeof(SnapshotHeader) + payloads.size() * sizeof(SnapshotSection);
+    for (Payload &payload : payloads) {
+        offset = (offset + 7) & ~uint64_t(7);
+        payload.section.offset = offset;
+        offset += payload.section.size;
+    }
+
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const Payload &payload : payloads) {
+        out.write(reinterpret_cast<const char *>(&payload.section), sizeof(SnapshotSection));
+    }
+    uint64_t written = sizeof(SnapshotHeader) + payloads.size() * sizeof(SnapshotSection);
+    static const char padding[8] = {};
+    for (const Payload &payload : payloads) {
+        out.write(padding, payload.section.offset - written);
+        out.write(static_cast<const char *>(payload.data), payload.section.size);
+        written = payload.section.offset + payload.section.size;
+    }
+    out.close();
+    // The caller discards the log once this returns true, so the new file
+    // and its directory entry must both be on disk by then
+    if (!out || !syncToDisk(tempPath)) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return std::rename(tempPath.c_str(), path.c_str()) == 0 && syncToDisk(parentDirectory(path), true);
+}
+
+inline bool saveSnapshot(const std::string &path, const GraphCore &graph, const SnapshotAttributes &attributes) {
+    return writeSnapshot(path, captureSnapshot(graph, attributes));
+}
+
+// Read-only mapping of a snapshot file
+class SnapshotFile {
+public:
+    explicit SnapshotFile(const std::string &path) : file(path) {
+        if (file.size() >= sizeof(SnapshotHeader)) {
+            base = file.data();
+            length = file.size();
+        }
+    }
+
+    // Header and section table are present and every section is in bounds
+    bool valid() const {
+        if (base == nullptr) {
+            return false;
+        }
+        const SnapshotHeader &h = header();
+        if (memcmp(h.magic, snapshotMagic, sizeof(h.magic)) != 0 || h.version != snapshotVersion) {
+            return false;
+        }
+        uint64_t tableEnd = sizeof(SnapshotHeader) + uint64_t(h.sectionCount) * sizeof(SnapshotSection);
+        if (tableEnd > length) {
+            return false;
+        }
+        for (uint32_t i = 0; i < h.sectionCount; ++i) {
+            const SnapshotSection &s = sections()[i];
+            if (s.offset % 8 != 0 || s.offset > length || s.size > length - s.offset) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const SnapshotHeader &header() const { return *reinterpret_cast<const SnapshotHeader *>(base); }
+
+    // Payload of a section as a typed array; count is set to the element count
+    template <typename T>
+    const T *find(uint32_t kind, uint32_t attribute, size_t &count) const {
+        for (uint32_t i = 0; i < header().sectionCount; ++i) {
+            const SnapshotSection &s = sections()[i];
+            if (s.kind == kind && s.attribute == attribute) {
+                count = s.size / sizeof(T);
+                return reinterpret_cast<const T *>(base + s.offset);
+            }
+        }
+        count = 0;
+        return nullptr;
+    }
+
+private:
+    MappedFile file;
+    const char *base = nullptr;
+    size_t length = 0;
+
+    const SnapshotSection *sections() const {
+        return reinterpret_cast<const SnapshotSection *>(base + sizeof(SnapshotHeader));
+    }
+};
+
+// Split a (offsets, bytes) string table into views over the mapping
+inline bool readStringTable(const uint64_t *offsets, size_t offsetCount, const char *bytes, size_t byteCount,
+                            std::vector<std::string_view> &out) {
+    if (offsets == nullptr || offsetCount == 0 || offsets[0] != 0 || offsets[offsetCount - 1] != byteCount) {
+        return false;
+    }
+    out.clear();
+    out.reserve(offsetCount - 1);
+    for (size_t i = 0; i + 1 < offsetCount; ++i) {
+        if (offsets[i] > offsets[i + 1]) {
+            return false;
+        }
+        out.emplace_back(bytes + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    return true;
+}
+
+// Load a snapshot into an empty graph and its attribute indexes.
+// Attributes are matched by name; returns false if the file is missing,
+// from another version, or inconsistent. `logSequence` receives the last
+// write-ahead log record already contained in the snapshot.
+inline bool loadSnapshot(const std::string &path, GraphCore &graph, const SnapshotAttributeTargets &attributes,
+                         uint64_t *logSequence = nullptr) {
+    SnapshotFile file(path);
+    if (!file.valid() || graph.userCount() != 0) {
+        return false;
+    }
+    const SnapshotHeader &header = file.header();
+    uint64_t userCount = header.userCount;
+
+    size_t count = 0, byteCount = 0;
+    const uint64_t *nameOffsets = file.find<uint64_t>(SectionNameOffsets, 0, count);
+    const char *nameBytes = file.find<char>(SectionNameBytes, 0, byteCount);
+    std::vector<std::string_view> names;
+    if (count != userCount + 1 || !readStringTable(nameOffsets, count, nameBytes, byteCount, names)) {
+        return false;
+    }
+
+    const uint64_t *rowOffsets = file.find<uint64_t>(SectionRowOffsets, 0, count);
+    if (rowOffsets == nullptr || count != userCount + 1 || rowOffsets[0] != 0) {
+        return false;
+    }
+    const uint32_t *adjacency = file.find<uint32_t>(SectionAdjacency, 0, count);
+    if (count != rowOffsets[userCount]) {
+        return false;
+    }
+    // findUser needs unique names, the intersection kernels sorted rows and
+    // hasEdge both directions of every connection
+    std::unordered_set<std::string_view> seen;
+    seen.reserve(names.size());
+    for (std::string_view name : names) {
+        if (!seen.insert(name).second) {
+            return false;
+        }
+    }
+    for (uint64_t u = 0; u < userCount; ++u) {
+        if (rowOffsets[u] > rowOffsets[u + 1]) {
+            return false;
+        }
+    }
+    for (uint64_t u = 0; u < userCount; ++u) {
+        for (uint64_t i = rowOffsets[u]; i < rowOffsets[u + 1]; ++i) {
+            uint32_t v = adjacency[i];
+            if (v >= userCount || v == u || (i > rowOffsets[u] && adjacency[i - 1] >= v)) {
+                return false;
+            }
+            if (!std::binary_search(adjacency + rowOffsets[v], adjacency + rowOffsets[v + 1], uint32_t(u))) {
+                return false;
+            }
+        }
+    }
+
+    // Resolve every requested attribute before touching the graph
+    struct AttributeTables {
+        AttributeIndex *index;
+        std::vector<std::string_view> values;
+        const uint32_t *userValues;
+    };
+    std::vector<AttributeTables> tables;
+    for (uint32_t a = 0; a < header.attributeCount; ++a) {
+        const char *label = file.find<char>(SectionAttributeName, a, byteCount);
+        std::string_view name(label, byteCount);
+        for (const auto &[wanted, index] : attributes) {
+            if (wanted != name) {
+                continue;
+            }
+            AttributeTables t{index, {}, nullptr};
+            const uint64_t *valueOffsets = file.find<uint64_t>(SectionValueOffsets, a, count);
+            const char *valueBytes = file.find<char>(SectionValueBytes, a, byteCount);
+            if (!readStringTable(valueOffsets, count, valueBytes, byteCount, t.values)) {
+                return false;
+            }
+            t.userValues = file.find<uint32_t>(SectionUserValues, a, count);
+            if (count != userCount) {
+                return false;
+            }
+            for (size_t u = 0; u < count; ++u) {
+                if (t.userValues[u] >= t.values.size()) {
+                    return false;
+                }
+            }
+            tables.push_back(std::move(t));
+        }
+    }
+
+    for (std::string_view name : names) {
+        graph.internUser(name);
+    }
+    graph.assignAdjacency(rowOffsets, adjacency);
+    for (const AttributeTables &t : tables) {
+        t.index->assign(t.values, t.userValues, userCount);
+    }
+
+    // Attributes the snapshot does not carry start out empty for everyone
+    std::vector<uint32_t> blank(userCount, 0);
+    for (const auto &[wanted, index] : attributes) {
+        bool loaded = false;
+        for (const AttributeTables &t : tables) {
+            loaded = loaded || t.index == index;
+        }
+        if (!loaded) {
+            index->assign({std::string_view()}, blank.data(), userCount);
+        }
+    }
+    if (logSequence != nullptr) {
+        *logSequence = header.logSequence;
+    }
+    return true;
+}
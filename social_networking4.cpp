@@ -1,504 +1,1335 @@
-#include <iostream>
-#include <unordered_map>
-#include <vector>
-#include <queue>
-#include <set>
-#include <string>
-#include <fstream>
-#include <algorithm>
-#include<SFML/Graphics.hpp>
-
-
-using namespace std;
-
-class NetworkManager {
-private:
-    unordered_map<string, vector<string>> connections; // User connections
-    set<string> users;                                // Registered users
-    unordered_map<string, string> departmentMap;      // Mapping users to departments
-    unordered_map<string, string> roleMap;           // Mapping users to roles
-
-    // Helper function to get mutual friends
-    set<string> findMutualConnections(const string &user1, const string &user2) {
-        set<string> mutualConnections;
-        if (connections.find(user1) == connections.end() || connections.find(user2) == connections.end()) {
-            return mutualConnections;
-        }
-        set<string> user1Connections(connections[user1].begin(), connections[user1].end());
-        for (const string &conn : connections[user2]) {
-            if (user1Connections.find(conn) != user1Connections.end()) {
-                mutualConnections.insert(conn);
-            }
-        }
-        return mutualConnections;
-    }
-
-public:
-    // Load user data from file
-    void loadUserData(const string &filename) {
-        ifstream fileInput(filename);
-        string username, department, role;
-        while (fileInput >> username >> department >> role) {
-            registerUser(username, department, role);
-        }
-        fileInput.close();
-    }
-
-    // Save user data to file
-    void saveUserData(const string &filename) {
-        ofstream fileOutput(filename);
-        for (const string &username : users) {
-            fileOutput << username << " " << departmentMap[username] << " " << roleMap[username] << endl;
-        }
-        fileOutput.close();
-    }
-
-    // Register a new user
-    void registerUser(const string &username, const string &department, const string &role, const string &interest) {
-        if (users.find(username) != users.end()) {
-            cout << username << " is already registered.\n";
-        } 
-        
-        else {
-            connections[username] = {};
-            users.insert(username);
-            departmentMap[username] = department;
-            roleMap[username] = role;
-            cout << username << " has been successfully registered.\n";
-        }
-    }
-
-    // Establish a connection between two users
-    void addConnection(const string &user1, const string &user2) {
-        if (user1 == user2) {
-
-            cout << "A user cannot connect with themselves.\n";
-
-            return;
-        }
-
-        if (connections.find(user1) == connections.end() || connections.find(user2) == connections.end()) {
-            cout << "Both users must be registered to connect.\n";
-            return;
-        }
-
-        connections[user1].push_back(user2);
-        connections[user2].push_back(user1);
-        cout << "Connection established between " << user1 << " and " << user2 << ".\n";
-    }
-    unordered_map<string, string> fieldOfInterestMap; // User -> Field of Interest
-
-// Add a field of interest for a user
-void addFieldOfInterest(const string &username, const string &interest) {
-    if (users.find(username) == users.end()) {
-        cout << username << " is not registered in the network.\n";
-        return;
-    }
-    fieldOfInterestMap[username] = interest;
-    cout << "Field of interest '" << interest << "' added to " << username << ".\n";
-}
-
-// List users by field of interest
-void listUsersByFieldOfInterest(const string &interest) {
-    cout << "\n--- Users Interested in " << interest << " ---\n";
-    bool found = false;
-    for (const auto &[user, field] : fieldOfInterestMap) {
-        if (field == interest) {
-            cout << user << " (" << roleMap[user] << ")\n";
-
-            found = true;
-        }
-    }
-    if (!found) {
-        cout << "No users found with this field of interest.\n";
-    }
-    cout << "--------------------------------\n";
-}
-
-    unordered_map<string, string> favoriteGamesMap; // User -> Favorite Games
-
-// Add favorite game for a user
-void addFavoriteGame(const string &username, const string &game) {
-    if (users.find(username) == users.end()) {
-        cout << username << " is not registered in the network.\n";
-        return;
-    }
-    favoriteGamesMap[username] = game;
-    cout << "Favorite game '" << game << "' added to " << username << ".\n";
-}
-
-// List users by favorite game
-void listUsersByFavoriteGame(const string &game) {
-    cout << "\n--- Users who like " << game << " ---\n";
-    bool found = false;
-    for (const auto &[user, favGame] : favoriteGamesMap) {
-        if (favGame == game) {
-            cout << user << " (" << roleMap[user] << ")\n";
-
-            found = true;
-        }
-    }
-    if (!found) {
-        cout << "No users found who like this game.\n";
-    }
-    cout << "--------------------------------\n";
-}
-
-        unordered_map<string, string> aimInLifeMap; // User -> Aim in Life
-
-// Add aim in life for a user
-void addAimInLife(const string &username, const string &aim) {
-    if (users.find(username) == users.end()) {
-        cout << username << " is not registered in the network.\n";
-        return;
-    }
-    aimInLifeMap[username] = aim;
-    cout << "Aim in life '" << aim << "' added to " << username << ".\n";
-}
-
-// List users by aim in life
-void listUsersByAim(const string &aim) {
-    cout << "\n--- Users who want to be a " << aim << " ---\n";
-    bool found = false;
-    for (const auto &[user, aimInLife] : aimInLifeMap) {
-        if (aimInLife == aim) {
-            cout << user << " (" << roleMap[user] << ")\n";
-            found = true;
-        }
-    }
-    if (!found) {
-        cout << "No users found with this aim in life.\n";
-    }
-    cout << "--------------------------------\n";
-}
-
-
-    // Display the entire network
-    void displayNetwork() {
-        cout << "\n--- Network Overview ---\n";
-        for (const auto &[user, connList] : connections) {
-            cout << user << " (" << departmentMap[user] << ", " << roleMap[user] << "): ";
-            for (const string &conn : connList) {
-                cout << conn << " ";
-            }
-            cout << "\n";
-        }
-        cout << "-------------------------\n";
-    }
-
-    // Export the network structure to a DOT file
-    void exportToDotFile(const string &filename) {
-        ofstream dotFile(filename);
-        if (!dotFile.is_open()) {
-            cout << "Unable to create DOT file.\n";
-            return;
-        }
-
-        dotFile << "graph NetworkGraph {\n";
-        for (const auto &[user, connList] : connections) {
-            for (const string &conn : connList) {
-                if (user < conn) {
-                    dotFile << "  \"" << user << "\" -- \"" << conn << "\";\n";
-                }
-            }
-        }
-        dotFile << "}\n";
-        dotFile.close();
-
-        cout << "Graph exported to " << filename << ". Use Graphviz or similar tools to visualize it.\n";
-    }
-
-    // List users in a specific department
-    void listUsersInDepartment(const string &department) {
-        cout << "\n--- Users in Department: " << department << " ---\n";
-        bool found = false;
-        for (const auto &[user, dept] : departmentMap) {
-            if (dept == department) {
-                cout << user << " (" << roleMap[user] << ")\n";
-                found = true;
-            }
-        }
-        if (!found) {
-            cout << "No users found in this department.\n";
-        }
-        cout << "--------------------------------\n";
-    }
-
-    // Suggest connections based on mutual friends
-    void suggestConnections(const string &username) {
-        if (connections.find(username) == connections.end()) {
-            cout << username << " is not registered in the network.\n";
-            return;
-        }
-
-        unordered_map<string, int> connectionSuggestions;
-        set<string> existingConnections(connections[username].begin(), connections[username].end());
-
-        for (const string &conn : connections[username]) {
-            for (const string &connOfConn : connections[conn]) {
-                if (connOfConn != username && existingConnections.find(connOfConn) == existingConnections.end()) {
-                    connectionSuggestions[connOfConn]++;
-                }
-            }
-        }
-
-        cout << "\n--- Connection Suggestions for " << username << " ---\n";
-        for (const auto &[suggestedUser, mutualCount] : connectionSuggestions) {
-            cout << suggestedUser << " (" << mutualCount << " mutual connections)\n";
-        }
-        cout << "-------------------------------------------\n";
-    }
-
-    // Find the shortest path between two users using BFS
-    void findShortestPath(const string &startUser, const string &endUser) {
-        if (connections.find(startUser) == connections.end() || connections.find(endUser) == connections.end()) {
-            cout << "Both users must be registered to find a connection path.\n";
-            return;
-        }
-
-        queue<string> queue;
-        unordered_map<string, string> parentMap;
-        set<string> visited;
-
-        queue.push(startUser);
-        visited.insert(startUser);
-        parentMap[startUser] = "";
-
-        while (!queue.empty()) {
-            string currentUser = queue.front();
-            queue.pop();
-
-            if (currentUser == endUser) {
-                vector<string> path;
-                for (string node = endUser; node != ""; node = parentMap[node]) {
-                    path.push_back(node);
-                }
-                reverse(path.begin(), path.end());
-                cout << "\n--- Shortest Path from " << startUser << " to " << endUser << " ---\n";
-                for (const string &node : path) {
-                    cout << node << (node == endUser ? "\n" : " -> ");
-                }
-                return;
-            }
-
-            for (const string &neighbor : connections[currentUser]) {
-                if (visited.find(neighbor) == visited.end()) {
-                    visited.insert(neighbor);
-                    parentMap[neighbor] = currentUser;
-                    queue.push(neighbor);
-                }
-            }
-        }
-
-        cout << "No path exists between " << startUser << " and " << endUser << ".\n";
-    }
-
-        unordered_map<string, string> aimInLifeMap; // User -> Aim in Life
-
-// Add aim in life for a user
-void addAimInLife(const string &username, const string &aim) {
-    if (users.find(username) == users.end()) {
-        cout << username << " is not registered in the network.\n";
-        return;
-    }
-    aimInLifeMap[username] = aim;
-    cout << "Aim in life '" << aim << "' added to " << username << ".\n";
-}
-
-// List users by aim in life
-void listUsersByAim(const string &aim) {
-    cout << "\n--- Users who want to be a " << aim << " ---\n";
-    bool found = false;
-    for (const auto &[user, aimInLife] : aimInLifeMap) {
-        if (aimInLife == aim) {
-            cout << user << " (" << roleMap[user] << ")\n";
-            found = true;
-        }
-    }
-    if (!found) {
-        cout << "No users found with this aim in life.\n";
-    }
-    cout << "--------------------------------\n";
-}
-
-
-    // Getter for connections
-    unordered_map<string, vector<string>> getConnections() const {
-        return connections;
-    }
-};
-
-// Function to visualize the network graph
-void visualizeNetwork(const unordered_map<string, vector<string>>& connections) {
-    sf::RenderWindow window(sf::VideoMode(800, 600), "Social Network Visualizer");
-
-    // Map user names to positions
-    unordered_map<string, sf::Vector2f> positions;
-    float angle = 0.0f;
-    float radius = 200.0f;
-    sf::Vector2f center(400, 300);
-
-    int totalUsers = connections.size();
-    for (const auto& [user, _] : connections) {
-        float x = center.x + radius * cos(angle);
-        float y = center.y + radius * sin(angle);
-        positions[user] = sf::Vector2f(x, y);
-        angle += 2 * M_PI / totalUsers;
-    }
-
-    while (window.isOpen()) {
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
-                window.close();
-        }
-
-        window.clear(sf::Color::Black);
-
-        // Draw edges
-        for (const auto& [user, friends] : connections) {
-            sf::Vector2f userPos = positions[user];
-            for (const string& friendName : friends) {
-                sf::Vector2f friendPos = positions[friendName];
-                sf::Vertex line[] = {
-                    sf::Vertex(userPos, sf::Color::White),
-                    sf::Vertex(friendPos, sf::Color::White)
-                };
-                window.draw(line, 2, sf::Lines);
-            }
-        }
-
-        // Draw nodes
-        for (const auto& [user, position] : positions) {
-            sf::CircleShape node(20);
-            node.setFillColor(sf::Color::Blue);
-            node.setPosition(position.x - 20, position.y - 20);
-            window.draw(node);
-
-            sf::Font font;
-            if (!font.loadFromFile("arial.ttf")) {
-                cerr << "Error loading font!\n";
-                return;
-            }
-            sf::Text text(user, font, 12);
-            text.setFillColor(sf::Color::White);
-            text.setPosition(position.x - 15, position.y - 15);
-            window.draw(text);
-        }
-
-        window.display();
-    }
-}
-
-int main() {
-    NetworkManager manager;
-    string fileName = "network_data.txt";
-    manager.loadUserData(fileName);
-
-    int choice;
-    string user1, user2, department, role;
-    string game;
-    string interest;
-    string aim;
-
-    while (true) {
-        cout << "\n--- Network Management Menu ---\n";
-        cout << "1. Register User\n";
-        cout << "2. Add Connection\n";
-        cout << "3. Display Network\n";
-        cout << "4. List Users by Department\n";
-        cout << "5. Suggest Connections\n";
-        cout << "6. Find Shortest Path\n";
-        cout << "7. Export Graph\n";
-        cout << "8. Visualize Network\n";
-        cout<<"9.list users by department\n";
-        cout<<"10.list users by interest";
-        cout<<"11.list users by aim";
-        cout << "9. Save and Exit\n";
-        cout << "Enter your choice: ";
-        cin >> choice;
-
-        switch (choice) {
-        case 1:
-            cout << "Enter username: ";
-            cin >> user1;
-            cout << "Enter department: ";
-            cin >> department;
-            cout << "Enter role (e.g., student/teacher): ";
-            cin >> role;
-            cout << "Enter field of interest (e.g., AI, Business, Economics): ";
-            cin >> interest;
-            cout << "Enter favorite game (e.g., Football, Chess): ";
-            cin >> game;
-            cout << "Enter aim in life (e.g., Doctor, Engineer, Entrepreneur): ";
-            cin >> aim;
-            manager.registerUser(user1, department, role, interest, game, aim);
-            break;
-            
-        case 2:
-            cout << "Enter first user: ";
-            cin >> user1;
-            cout << "Enter second user: ";
-            cin >> user2;
-            manager.addConnection(user1, user2);
-            break;
-        case 3:
-            manager.displayNetwork();
-            break;
-        case 4:
-            cout << "Enter department: ";
-            cin >> department;
-            manager.listUsersInDepartment(department);
-            break;
-        case 5:
-            cout << "Enter username for suggestions: ";
-            cin >> user1;
-            manager.suggestConnections(user1);
-            break;
-        case 6:
-            cout << "Enter start user: ";
-            cin >> user1;
-            cout << "Enter end user: ";
-            cin >> user2;
-            manager.findShortestPath(user1, user2);
-            break;
-        case 7:
-            cout << "Enter filename to export graph (e.g., graph.dot): ";
-            cin >> user1;
-            manager.exportToDotFile(user1);
-            break;
-        case 8:
-            cout<<"Visualize Network\n";
-            visualizeNetwork(manager.getConnections());
-
-            cout<<"...............................";
-            break;
-    case 9:
-        cout << "Enter department to search: ";
-
-        cin >> department;
-
-        manager.listUsersInDepartment(department);
-        break;
-
-    case 10:
-        cout << "Enter field of interest to search: ";
-        cin >> interest;
-        manager.listUsersByFieldOfInterest(interest);
-        break;
-
-    case 11:
-        cout << "Enter aim in life to search: ";
-        cin >> aim;
-        manager.listUsersByAim(aim);
-        break;
-
-        case 12:
-            manager.saveUserData(fileName);
-            cout << "Data saved. Exiting...\n";
-            return 0;
-        default:
-            cout << "Invalid option. Please try again.\n";
-        }
-    }
-}
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+#include <queue>
+#include <set>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include<SFML/Graphics.hpp>
+#include "graph_core.hpp"
+#include "graph_view.hpp"
+#include "graph_paths.hpp"
+#include "graph_suggest.hpp"
+#include "attribute_index.hpp"
+#include "snapshot.hpp"
+#include "write_ahead_log.hpp"
+#include "bulk_ingest.hpp"
+#include "batch_runner.hpp"
+#include "suggestion_table.hpp"
+#include "graph_intersect.hpp"
+#include "graph_neighborhood.hpp"
+#include "graph_distances.hpp"
+#include "landmark_index.hpp"
+#include "result_cache.hpp"
+#include "output_buffer.hpp"
+#include "network_renderer.hpp"
+#include "force_layout.hpp"
+#include "network_image.hpp"
+#include "network_report.hpp"
+
+
+using namespace std;
+
+class NetworkManager {
+private:
+    GraphCore graph;                // Interned user ids + CSR connections
+    AttributeIndex departments;     // User id <-> department
+    AttributeIndex roles;           // User id <-> role
+    AttributeIndex interests;       // User id <-> field of interest
+    AttributeIndex games;           // User id <-> favorite game
+    AttributeIndex aims;            // User id <-> aim in life
+    string snapshotPath;            // Binary snapshot of the whole network
+    string logPath;                 // Mutations made since that snapshot
+    string suggestionPath;          // Precomputed suggestions for every user
+    string landmarkPath;            // Landmark distance index for path estimates
+    string layoutPath;              // Visualizer positions from the last layout
+    WriteAheadLog mutationLog;
+    LogCompactor compactor;
+    static constexpr uint64_t compactThreshold = 8 << 20; // Log growth between compactions
+    uint64_t compactAt = compactThreshold;                // Log size that triggers the next compaction
+    SuggestionTable suggestionTable;
+    LandmarkIndex landmarkIndex;
+    ResultCache resultCache;        // Rendered results of repeated queries
+
+    // Top-k suggestions, served from the precomputed table while it is current
+    vector<Suggestion> suggestionsFor(uint32_t id, size_t k) {
+        if (suggestionTable.covers(k, mutationLog.lastSequence(), graph.userCount())) {
+            return suggestionTable.lookup(id, k);
+        }
+        return suggestTopK(graph, id, k);
+    }
+
+    // Bounds on the distance between two ids and a path of length `upper`:
+    // from the landmark index while it is current, otherwise exact by BFS.
+    // Users in different components get unknown bounds and no path.
+    DistanceEstimate estimateDistance(uint32_t start, uint32_t end, vector<uint32_t> &path) {
+        DistanceEstimate estimate;
+        path.clear();
+        if (!graph.sameComponent(start, end)) {
+            estimate.lower = DistanceEstimate::unknown;
+            return estimate;
+        }
+        if (landmarkIndex.covers(mutationLog.lastSequence(), graph.userCount())) {
+            estimate = landmarkIndex.estimate(start, end);
+            path = landmarkIndex.pathThrough(graph, start, end, estimate);
+            if (!path.empty()) {
+                estimate.upper = min(estimate.upper, static_cast<uint32_t>(path.size() - 1));
+                return estimate;
+            }
+        }
+        path = shortestPathBetween(graph, start, end);
+        estimate.lower = estimate.upper = static_cast<uint32_t>(path.size() - 1);
+        return estimate;
+    }
+
+    // Shortest path between two ids: the landmark path when the index proves
+    // it shortest, bidirectional BFS otherwise
+    vector<uint32_t> shortestPath(uint32_t start, uint32_t end) {
+        vector<uint32_t> path;
+        if (estimateDistance(start, end, path).exact() || path.empty()) {
+            return path;
+        }
+        return shortestPathBetween(graph, start, end);
+    }
+
+    // Helper function to get mutual friends. With an attribute index, only
+    // those sharing user1's value of that attribute are returned.
+    vector<uint32_t> findMutualConnections(uint32_t user1, uint32_t user2, const AttributeIndex *filter = nullptr) {
+        if (filter == nullptr) {
+            return mutualConnections(graph, user1, user2);
+        }
+        return mutualConnections(graph, user1, user2, filter->usersWith(filter->valueOf(user1)));
+    }
+
+    // Expire cached results that list the users holding `value` of `attribute`
+    void touchAttribute(string_view attribute, string_view value) {
+        resultCache.touch({CacheDependency::Attribute, attributeKey(attribute, value)});
+        resultCache.touch({CacheDependency::Attribute, attributeKey(attribute)});
+    }
+
+    // Change one user's attribute value, expiring listings of the old and new value
+    void setAttribute(string_view attribute, AttributeIndex &index, uint32_t id, string_view value) {
+        touchAttribute(attribute, index.valueOf(id));
+        index.set(id, value);
+        touchAttribute(attribute, value);
+    }
+
+    // Add a connection, expiring cached results that read either user's
+    // neighbours or searched either user's component
+    bool connectUsers(uint32_t id1, uint32_t id2) {
+        uint32_t component1 = graph.componentOf(id1);
+        uint32_t component2 = graph.componentOf(id2);
+        if (!graph.addEdge(id1, id2)) {
+            return false;
+        }
+        resultCache.touch({CacheDependency::Adjacency, id1});
+        resultCache.touch({CacheDependency::Adjacency, id2});
+        resultCache.touch({CacheDependency::Component, component1});
+        resultCache.touch({CacheDependency::Component, component2});
+        return true;
+    }
+
+    // Suggestions for a user are computed from its neighbours' neighbour lists
+    vector<CacheDependency> suggestionDependencies(uint32_t id) {
+        vector<CacheDependency> dependencies{{CacheDependency::Adjacency, id}};
+        for (uint32_t neighbor : graph.neighbors(id)) {
+            dependencies.push_back({CacheDependency::Adjacency, neighbor});
+        }
+        return dependencies;
+    }
+
+    // Any new connection inside the users' component(s) may create a shorter path
+    vector<CacheDependency> pathDependencies(uint32_t start, uint32_t end) {
+        return {{CacheDependency::Component, graph.componentOf(start)},
+                {CacheDependency::Component, graph.componentOf(end)}};
+    }
+
+    // Print a cached result block, or render it with `render(text)` (which
+    // returns what the result depends on), cache it and print it
+    template <typename Render>
+    void printCached(const string &key, Render render) {
+        if (const string *cached = resultCache.find(key)) {
+            standardOutput().write(*cached);
+            return;
+        }
+        OutputBuffer text;
+        vector<CacheDependency> dependencies = render(text);
+        standardOutput().write(resultCache.insert(key, string(text.text()), move(dependencies)));
+    }
+
+    // Store a new user and its attributes; false if the name is taken
+    bool insertUser(string_view username, string_view department, string_view role,
+                    string_view interest, string_view game, string_view aim) {
+        if (graph.contains(username)) {
+            return false;
+        }
+        uint32_t id = graph.internUser(username);
+        departments.addUser(id, department);
+        roles.addUser(id, role);
+        interests.addUser(id, interest);
+        games.addUser(id, game);
+        aims.addUser(id, aim);
+        touchAttribute("department", department);
+        touchAttribute("role", role);
+        touchAttribute("interest", interest);
+        touchAttribute("game", game);
+        touchAttribute("aim", aim);
+        return true;
+    }
+
+    // Attribute tables persisted with the graph, by name
+    SnapshotAttributeTargets attributeTables() {
+        return {{"department", &departments}, {"role", &roles}, {"interest", &interests}, {"game", &games}, {"aim", &aims}};
+    }
+
+    // Attribute index by its storage name ("department", "role", ...); nullptr if unknown
+    const AttributeIndex *attributeNamed(string_view name) {
+        for (const auto &[attribute, index] : attributeTables()) {
+            if (attribute == name) {
+                return index;
+            }
+        }
+        return nullptr;
+    }
+
+    SnapshotImage captureNetwork() {
+        SnapshotAttributeTargets tables = attributeTables();
+        SnapshotImage image = captureSnapshot(graph, SnapshotAttributes(tables.begin(), tables.end()));
+        image.logSequence = mutationLog.lastSequence();
+        return image;
+    }
+
+    // Re-apply one logged mutation without printing or logging it again
+    void applyLogRecord(LogRecordType type, const vector<string_view> &fields) {
+        if (type == LogRegisterUser && fields.size() == 6) {
+            insertUser(fields[0], fields[1], fields[2], fields[3], fields[4], fields[5]);
+        } else if (type == LogAddConnection && fields.size() == 2) {
+            uint32_t id1 = graph.findUser(fields[0]);
+            uint32_t id2 = graph.findUser(fields[1]);
+            if (id1 != GraphCore::npos && id2 != GraphCore::npos) {
+                connectUsers(id1, id2);
+            }
+        } else if (type == LogSetAttribute && fields.size() == 3) {
+            uint32_t id = graph.findUser(fields[1]);
+            for (const auto &[name, index] : attributeTables()) {
+                if (name == fields[0] && id != GraphCore::npos) {
+                    setAttribute(name, *index, id, fields[2]);
+                }
+            }
+        }
+    }
+
+    // Fold the log into a new snapshot in the background once it grows large.
+    // Storage diagnostics here and in logMutation() go to cerr, so they never
+    // mix into --batch results on standard output.
+    void maybeCompact() {
+        if (compactor.busy()) {
+            return;
+        }
+        if (compactor.takeFailure()) {
+            cerr << "Unable to write " << snapshotPath << "; keeping " << logPath
+                 << ".old and retrying after further changes.\n";
+            compactAt = mutationLog.size() + compactThreshold;
+        }
+        if (mutationLog.size() < compactAt) {
+            return;
+        }
+        compactor.wait();
+        compactAt = compactThreshold;
+        // If a failed compaction left its archive behind the log is not rotated
+        // (that would overwrite it); the snapshot is retried all the same and,
+        // once written, covers both files
+        SnapshotImage image = captureNetwork();
+        mutationLog.rotate(logPath + ".old");
+        compactor.start(move(image), snapshotPath, logPath + ".old");
+    }
+
+    // Append one mutation to the log, compacting if it has grown large
+    void logMutation(LogRecordType type, initializer_list<string_view> fields) {
+        mutationLog.append(type, fields);
+        if (mutationLog.takeFailure()) {
+            cerr << "Unable to write " << logPath << "; unsaved changes are kept and retried.\n";
+        }
+        maybeCompact();
+    }
+
+    // Write "name" list items for a set of ids
+    void writeNames(BatchWriter &out, const vector<uint32_t> &ids) {
+        out.beginList();
+        for (uint32_t id : ids) {
+            out.item(graph.nameOf(id));
+        }
+    }
+
+    // Serve a batch command from the result cache, or run `write` (which
+    // writes the fields of one line and returns what the result depends on)
+    // and cache the line
+    template <typename Write>
+    void cachedBatchLine(const vector<string_view> &args, BatchWriter &out, Write write) {
+        string key;
+        for (string_view arg : args) {
+            key += arg;
+            key += '\t';
+        }
+        if (const string *cached = resultCache.find(key)) {
+            out.lines(*cached);
+            return;
+        }
+        size_t start = out.mark();
+        vector<CacheDependency> dependencies = write();
+        string line(out.since(start));
+        line += '\n';
+        out.endLine();
+        resultCache.insert(key, move(line), move(dependencies));
+    }
+
+    // Write one department's DOT subgraph: its members and the connections
+    // between them, formatted into an OutputBuffer that goes out in large writes
+    bool writeDepartmentGraph(const GraphView &network, const string &filename, uint32_t department) const {
+        OutputBuffer dotFile;
+        if (!dotFile.open(filename)) {
+            return false;
+        }
+        const string &name = departments.valueName(department);
+        const vector<uint32_t> &members = departments.usersWith(name);
+        const vector<uint32_t> &departmentOf = departments.userValueIds();
+
+        dotFile << "graph \"" << name << "_Network\" {\n";
+        dotFile << "  node [shape=ellipse, style=filled, fillcolor=lightyellow];\n";
+        for (uint32_t user : members) {
+            dotFile << "  \"" << network.nameOf(user) << "\" [label=\"" << network.nameOf(user) << "\\n"
+                    << roles.valueOf(user) << "\\n" << interests.valueOf(user) << "\\n" << games.valueOf(user)
+                    << "\"];\n";
+            dotFile.flushIfFull();
+        }
+        for (uint32_t user : members) {
+            for (uint32_t conn : network.neighbors(user)) {
+                if (user < conn && departmentOf[conn] == department) {
+                    dotFile << "  \"" << network.nameOf(user) << "\" -- \"" << network.nameOf(conn) << "\";\n";
+                    dotFile.flushIfFull();
+                }
+            }
+        }
+        dotFile << "}\n";
+        return dotFile.close();
+    }
+
+    // One DOT file per department (outputDir/<department>_graph.dot), each
+    // written once from the department's posting list, departments in
+    // parallel. Returns every file name with whether it was written.
+    vector<pair<string, bool>> exportDepartmentGraphs(const string &outputDir) {
+        error_code error;
+        filesystem::create_directories(outputDir, error);
+        GraphView network = view(); // workers only read the graph
+        vector<uint32_t> exported;
+        for (uint32_t value = 0; value < departments.valueCount(); ++value) {
+            const string &name = departments.valueName(value);
+            if (!name.empty() && !departments.usersWith(name).empty()) {
+                exported.push_back(value);
+            }
+        }
+
+        vector<pair<string, bool>> files(exported.size());
+        ThreadPool::shared().parallelFor(exported.size(), 1, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                files[i].first = outputDir + "/" + departments.valueName(exported[i]) + "_graph.dot";
+                files[i].second = writeDepartmentGraph(network, files[i].first, exported[i]);
+            }
+        });
+        return files;
+    }
+
+    // Execute one --batch command and write its result line
+    void executeBatchCommand(const vector<string_view> &args, BatchWriter &out) {
+        string_view command = args[0];
+        if (command == "path" && args.size() == 3) {
+            uint32_t start = graph.findUser(args[1]);
+            uint32_t end = graph.findUser(args[2]);
+            if (start == GraphCore::npos || end == GraphCore::npos) {
+                out.error(command, "unknown user");
+                return;
+            }
+            cachedBatchLine(args, out, [&] {
+                vector<uint32_t> path = shortestPath(start, end);
+                out.field(command).field(args[1]).field(args[2]).field(static_cast<int64_t>(path.size()) - 1);
+                writeNames(out, path);
+                return pathDependencies(start, end);
+            });
+        } else if (command == "estimate" && args.size() == 3) {
+            uint32_t start = graph.findUser(args[1]);
+            uint32_t end = graph.findUser(args[2]);
+            if (start == GraphCore::npos || end == GraphCore::npos) {
+                out.error(command, "unknown user");
+                return;
+            }
+            vector<uint32_t> path;
+            DistanceEstimate estimate = estimateDistance(start, end, path);
+            int64_t lower = estimate.lower == DistanceEstimate::unknown ? -1 : static_cast<int64_t>(estimate.lower);
+            int64_t upper = estimate.upper == DistanceEstimate::unknown ? -1 : static_cast<int64_t>(estimate.upper);
+            out.field(command).field(args[1]).field(args[2]).field(lower).field(upper);
+            writeNames(out, path);
+            out.endLine();
+        } else if (command == "suggest" && (args.size() == 2 || args.size() == 3)) {
+            uint32_t id = graph.findUser(args[1]);
+            size_t k = 10;
+            if (id == GraphCore::npos || (args.size() == 3 && !parseCount(args[2], k))) {
+                out.error(command, id == GraphCore::npos ? "unknown user" : "bad count");
+                return;
+            }
+            cachedBatchLine(args, out, [&] {
+                vector<Suggestion> suggestions = suggestionsFor(id, k);
+                out.field(command).field(args[1]).field(static_cast<int64_t>(suggestions.size())).beginList();
+                for (const Suggestion &suggestion : suggestions) {
+                    out.item(graph.nameOf(suggestion.user), suggestion.mutualCount);
+                }
+                return suggestionDependencies(id);
+            });
+        } else if (command == "connect" && args.size() == 3) {
+            uint32_t id1 = graph.findUser(args[1]);
+            uint32_t id2 = graph.findUser(args[2]);
+            bool unknown = id1 == GraphCore::npos || id2 == GraphCore::npos;
+            if (unknown || id1 == id2) {
+                out.error(command, unknown ? "unknown user" : "self connection");
+                return;
+            }
+            if (!connectUsers(id1, id2)) {
+                out.error(command, "already connected");
+                return;
+            }
+            logMutation(LogAddConnection, {args[1], args[2]});
+            out.field(command).field(args[1]).field(args[2]).field("ok").endLine();
+        }
+        else if (command == "register" && (args.size() == 4 || args.size() == 7)) {
+            string_view interest = args.size() == 7 ? args[4] : "";
+            string_view game = args.size() == 7 ? args[5] : "";
+            string_view aim = args.size() == 7 ? args[6] : "";
+            if (!insertUser(args[1], args[2], args[3], interest, game, aim)) {
+                out.error(command, "already registered");
+                return;
+            }
+            logMutation(LogRegisterUser, {args[1], args[2], args[3], interest, game, aim});
+            out.field(command).field(args[1]).field("ok").endLine();
+        } else if (command == "mutual" && (args.size() == 3 || args.size() == 4)) {
+            uint32_t id1 = graph.findUser(args[1]);
+            uint32_t id2 = graph.findUser(args[2]);
+            const AttributeIndex *filter = args.size() == 4 ? attributeNamed(args[3]) : nullptr;
+            if (id1 == GraphCore::npos || id2 == GraphCore::npos || (args.size() == 4 && filter == nullptr)) {
+                out.error(command, filter == nullptr && args.size() == 4 ? "unknown attribute" : "unknown user");
+                return;
+            }
+            vector<uint32_t> mutual = findMutualConnections(id1, id2, filter);
+            out.field(command).field(args[1]).field(args[2]).field(static_cast<int64_t>(mutual.size()));
+            writeNames(out, mutual);
+            out.endLine();
+        } else if ((command == "reach" || command == "hops") && args.size() == 3) {
+            uint32_t id = graph.findUser(args[1]);
+            size_t k = 0;
+            if (id == GraphCore::npos || !parseCount(args[2], k)) {
+                out.error(command, id == GraphCore::npos ? "unknown user" : "bad count");
+                return;
+            }
+            HopNeighborhood hood = kHopNeighborhood(graph, id, static_cast<uint32_t>(min<size_t>(k, UINT32_MAX)),
+                                                    command == "hops");
+            out.field(command).field(args[1]).field(args[2]).field(static_cast<int64_t>(hood.total())).beginList();
+            for (size_t hop = 0; hop < hood.counts.size(); ++hop) {
+                if (command == "reach") {
+                    out.item(to_string(hood.counts[hop]));
+                    continue;
+                }
+                for (uint32_t user : hood.ids[hop]) {
+                    out.item(graph.nameOf(user), static_cast<int64_t>(hop + 1));
+                }
+            }
+            out.endLine();
+        } else if (command == "distances" && args.size() == 2) {
+            uint32_t id = graph.findUser(args[1]);
+            if (id == GraphCore::npos) {
+                out.error(command, "unknown user");
+                return;
+            }
+            ParallelBfs bfs;
+            bfs.run(graph, id);
+            out.field(command).field(args[1]).field(static_cast<int64_t>(bfs.eccentricity()));
+            out.field(static_cast<int64_t>(bfs.reachableCount())).beginList();
+            for (uint64_t size : bfs.levelSizes()) {
+                out.item(to_string(size));
+            }
+            out.endLine();
+        } else if (command == "component" && args.size() == 2) {
+            uint32_t id = graph.findUser(args[1]);
+            if (id == GraphCore::npos) {
+                out.error(command, "unknown user");
+                return;
+            }
+            out.field(command).field(args[1]).field(static_cast<int64_t>(graph.componentSize(id)));
+            out.field(graph.nameOf(graph.componentOf(id))).endLine();
+        } else if (command == "components" && args.size() <= 2) {
+            size_t k = 10;
+            if (args.size() == 2 && !parseCount(args[1], k)) {
+                out.error(command, "bad count");
+                return;
+            }
+            vector<uint32_t> sizes = graph.componentSizes();
+            out.field(command).field(static_cast<int64_t>(sizes.size())).beginList();
+            for (size_t i = 0; i < sizes.size() && (k == 0 || i < k); ++i) {
+                out.item(to_string(sizes[i]));
+            }
+            out.endLine();
+        } else if (args.size() == 2 && (command == "dept" || command == "role" || command == "interest" ||
+                                        command == "game" || command == "aim")) {
+            const AttributeIndex &index = command == "dept" ? departments
+                                        : command == "role" ? roles
+                                        : command == "interest" ? interests
+                                        : command == "game" ? games : aims;
+            string_view attribute = command == "dept" ? "department" : command;
+            cachedBatchLine(args, out, [&] {
+                const vector<uint32_t> &matches = index.usersWith(args[1]);
+                out.field(command).field(args[1]).field(static_cast<int64_t>(matches.size()));
+                writeNames(out, matches);
+                return vector<CacheDependency>{{CacheDependency::Attribute, attributeKey(attribute, args[1])}};
+            });
+        } else if (command == "deptgraphs" && args.size() == 2) {
+            vector<pair<string, bool>> files = exportDepartmentGraphs(string(args[1]));
+            for (const auto &[filename, written] : files) {
+                if (!written) {
+                    out.error(command, "unable to write " + filename);
+                    return;
+                }
+            }
+            out.field(command).field(args[1]).field(static_cast<int64_t>(files.size())).beginList();
+            for (const auto &file : files) {
+                out.item(file.first);
+            }
+            out.endLine();
+        } else if (command == "cache" && args.size() == 1) {
+            out.field(command).field(static_cast<int64_t>(resultCache.hits()));
+            out.field(static_cast<int64_t>(resultCache.misses())).field(static_cast<int64_t>(resultCache.staleDrops()));
+            out.field(static_cast<int64_t>(resultCache.size())).endLine();
+        } else {
+            out.error(command, "unknown command or wrong number of arguments");
+        }
+    }
+
+public:
+    // Import users from a whitespace text file (username department role per line)
+    void loadUserData(const string &filename) {
+        ifstream fileInput(filename);
+        string username, department, role;
+        while (fileInput >> username >> department >> role) {
+            insertUser(username, department, role, "", "", "");
+        }
+        fileInput.close();
+    }
+
+    // Save user data to file
+    void saveUserData(const string &filename) {
+        OutputBuffer fileOutput;
+        fileOutput.open(filename);
+        for (uint32_t user = 0; user < graph.userCount(); ++user) {
+            fileOutput << graph.nameOf(user) << " " << departments.valueOf(user) << " " << roles.valueOf(user) << "\n";
+            fileOutput.flushIfFull();
+        }
+        fileOutput.close();
+    }
+
+    // Load the snapshot, replay the log on top of it and start logging.
+    // Returns false if neither file held any data.
+    bool openStorage(const string &snapshotFile, const string &logFile, const string &suggestionFile,
+                     const string &landmarkFile, const string &layoutFile) {
+        snapshotPath = snapshotFile;
+        logPath = logFile;
+        suggestionPath = suggestionFile;
+        landmarkPath = landmarkFile;
+        layoutPath = layoutFile;
+        suggestionTable.open(suggestionPath);
+        landmarkIndex.open(landmarkPath);
+        uint64_t sequence = 0;
+        bool loaded = loadSnapshot(snapshotPath, graph, attributeTables(), &sequence);
+
+        // A leftover archive means a compaction was interrupted: replay it first
+        auto apply = [this](LogRecordType type, const vector<string_view> &fields) { applyLogRecord(type, fields); };
+        uint64_t archived = WriteAheadLog::replay(logPath + ".old", sequence, apply);
+        uint64_t intactBytes = 0;
+        uint64_t last = WriteAheadLog::replay(logPath, archived, apply, &intactBytes);
+        if (!mutationLog.open(logPath, last, intactBytes)) {
+            cerr << "Unable to open " << logPath << "; changes will not be logged.\n";
+        }
+        if (archived > sequence) {
+            saveNetwork();
+        } else {
+            remove((logPath + ".old").c_str()); // Nothing in it the snapshot lacks
+        }
+        return loaded || last > sequence;
+    }
+
+    // Write a full snapshot now and truncate the log
+    bool saveNetwork() {
+        compactor.wait();
+        mutationLog.sync();
+        compactor.takeFailure(); // Superseded by this snapshot
+        if (!writeSnapshot(snapshotPath, captureNetwork())) {
+            return false;
+        }
+        // The snapshot covers the archive of an earlier failed compaction too
+        remove((logPath + ".old").c_str());
+        if (mutationLog.rotate(logPath + ".old")) {
+            remove((logPath + ".old").c_str());
+        }
+        return true;
+    }
+
+    // Bulk-load a user file (username department role [interest game aim] per line) and an
+    // edge-list file (user1 user2 per line); pass "-" to skip either one.
+    // Both are parsed in parallel; the edges are merged into the CSR in one pass.
+    void bulkImport(const string &userFile, const string &edgeFile) {
+        IngestStats stats;
+        auto started = chrono::steady_clock::now();
+        auto addUser = [this](const array<string_view, 6> &fields) {
+            insertUser(fields[0], fields[1], fields[2], fields[3], fields[4], fields[5]);
+        };
+        if (userFile != "-" && !ingestUsers<6>(userFile, addUser, &stats.users)) {
+            cout << "Unable to read " << userFile << ".\n";
+            return;
+        }
+        if (edgeFile != "-") {
+            auto addEdgeOnlyUser = [this](uint32_t id) {
+                departments.addUser(id, "");
+                roles.addUser(id, "");
+                interests.addUser(id, "");
+                games.addUser(id, "");
+                aims.addUser(id, "");
+            };
+            IngestStats edgeStats;
+            if (!ingestEdges(edgeFile, graph, addEdgeOnlyUser, &edgeStats)) {
+                cout << "Unable to read " << edgeFile << "; no connections were imported.\n";
+                if (userFile == "-") {
+                    return;
+                }
+            }
+            stats.edges = edgeStats.edges;
+            stats.newUsers = edgeStats.newUsers;
+        }
+        // The import is not logged, so the sequence cannot tell the tables are stale
+        suggestionTable.close();
+        remove(suggestionPath.c_str());
+        landmarkIndex.close();
+        remove(landmarkPath.c_str());
+        resultCache.clear();
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+        cout << "Imported " << stats.users << " users and " << stats.edges << " connections ("
+             << stats.newUsers << " users created from the edge list) in " << stats.seconds << "s, "
+             << static_cast<uint64_t>(stats.edgesPerSecond()) << " edges/s.\n";
+        if (!saveNetwork()) {
+            cout << "Unable to write " << snapshotPath << ".\n";
+        }
+    }
+
+    // Rank suggestions for every user in parallel and store them for
+    // suggestConnections to serve; k = 0 keeps every candidate
+    void precomputeAllSuggestions(size_t k) {
+        SuggestionTableStats stats;
+        if (!buildSuggestionTable(suggestionPath, graph, k, mutationLog.lastSequence(), &stats) ||
+            !suggestionTable.open(suggestionPath)) {
+            cout << "Unable to write " << suggestionPath << ".\n";
+            return;
+        }
+        cout << "Precomputed " << stats.entries << " suggestions for " << stats.users << " users in " << stats.seconds
+             << "s on " << stats.threads << " threads (" << static_cast<uint64_t>(stats.usersPerSecond())
+             << " users/s).\n";
+    }
+
+    // Pick `count` landmarks and index every user's distance to them (one
+    // parallel BFS per landmark) so path queries can be estimated instantly
+    void buildLandmarks(size_t count, LandmarkSelection selection) {
+        LandmarkIndexStats stats;
+        if (!buildLandmarkIndex(landmarkPath, graph, count, selection, mutationLog.lastSequence(), &stats) ||
+            !landmarkIndex.open(landmarkPath)) {
+            cout << "Unable to write " << landmarkPath << ".\n";
+            return;
+        }
+        cout << "Indexed distances from " << stats.landmarks << " landmarks to " << stats.users << " users in "
+             << stats.seconds << "s on " << stats.threads << " threads.\n";
+    }
+
+    // Positions of every user for the visualizer: the cached layout if no
+    // user or connection was added since, updated incrementally if some were,
+    // computed from scratch if there is no usable cache. The result is cached.
+    vector<LayoutPoint> networkLayout() {
+        vector<LayoutPoint> positions;
+        vector<uint32_t> degrees;
+        GraphView network = view();
+        bool cached = readLayoutCache(layoutPath, positions, degrees) && positions.size() <= network.userCount();
+        if (cached && positions.size() == network.userCount()) {
+            uint32_t user = 0;
+            while (user < network.userCount() && network.degree(user) == degrees[user]) {
+                ++user;
+            }
+            if (user == network.userCount()) {
+                return positions;
+            }
+        }
+
+        ForceLayout layout;
+        LayoutStats stats;
+        if (cached) {
+            layout.extend(network, positions, degrees, &stats);
+        } else {
+            positions = layout.compute(network, &stats);
+        }
+        if (!writeLayoutCache(layoutPath, network, positions)) {
+            cout << "Unable to write " << layoutPath << ".\n";
+        }
+        cout << (stats.incremental ? "Updated the layout of " : "Laid out ") << stats.moved << " of " << stats.users
+             << " users in " << stats.seconds << "s on " << stats.threads << " threads.\n";
+        return positions;
+    }
+
+    // Draw the network to an image file without a display; the format
+    // follows the extension (.svg, .png, anything else is PPM)
+    void renderNetworkImage(const string &path, unsigned width) {
+        vector<LayoutPoint> layout = networkLayout();
+        ImageOptions options;
+        options.width = width;
+        ImageStats stats;
+        if (!writeNetworkImage(path, view(), layout, departments.userValueIds(), options, &stats)) {
+            cout << "Unable to write " << path << ".\n";
+            return;
+        }
+        cout << "Rendered " << stats.users << " users and " << stats.edges << " connections to " << path << " ("
+             << stats.width << "x" << stats.height << ") in " << stats.seconds << "s on " << stats.threads
+             << " threads.\n";
+    }
+
+    // Zero-copy read-only view of the network for the visualizer, exporters
+    // and analytics; valid until the next registration or connection
+    GraphView view() const { return GraphView(graph); }
+
+    // Run a command file ("-" for stdin) without the interactive menu
+    size_t runBatch(const string &path) {
+        return runBatchFile(path, [this](const vector<string_view> &args, BatchWriter &out) {
+            executeBatchCommand(args, out);
+        });
+    }
+
+    // Register a new user
+    void registerUser(const string &username, const string &department, const string &role,
+                      const string &interest, const string &game, const string &aim) {
+        if (!insertUser(username, department, role, interest, game, aim)) {
+            cout << username << " is already registered.\n";
+        } 
+        
+        else {
+            logMutation(LogRegisterUser, {username, department, role, interest, game, aim});
+            cout << username << " has been successfully registered.\n";
+        }
+    }
+
+    // Establish a connection between two users
+    void addConnection(const string &user1, const string &user2) {
+        if (user1 == user2) {
+
+            cout << "A user cannot connect with themselves.\n";
+
+            return;
+        }
+
+        uint32_t id1 = graph.findUser(user1);
+        uint32_t id2 = graph.findUser(user2);
+        if (id1 == GraphCore::npos || id2 == GraphCore::npos) {
+            cout << "Both users must be registered to connect.\n";
+            return;
+        }
+
+        if (!connectUsers(id1, id2)) {
+            cout << user1 << " and " << user2 << " are already connected.\n";
+            return;
+        }
+        logMutation(LogAddConnection, {user1, user2});
+        cout << "Connection established between " << user1 << " and " << user2 << ".\n";
+    }
+
+// Add a field of interest for a user
+void addFieldOfInterest(const string &username, const string &interest) {
+    uint32_t id = graph.findUser(username);
+    if (id == GraphCore::npos) {
+        cout << username << " is not registered in the network.\n";
+        return;
+    }
+    setAttribute("interest", interests, id, interest);
+    logMutation(LogSetAttribute, {"interest", username, interest});
+    cout << "Field of interest '" << interest << "' added to " << username << ".\n";
+}
+
+// List users by field of interest
+void listUsersByFieldOfInterest(const string &interest) {
+    writeUserListing(standardOutput(), "Users Interested in " + interest, interests.usersWith(interest), graph, roles,
+                     "No users found with this field of interest.");
+}
+
+// Add favorite game for a user
+void addFavoriteGame(const string &username, const string &game) {
+    uint32_t id = graph.findUser(username);
+    if (id == GraphCore::npos) {
+        cout << username << " is not registered in the network.\n";
+        return;
+    }
+    setAttribute("game", games, id, game);
+    logMutation(LogSetAttribute, {"game", username, game});
+    cout << "Favorite game '" << game << "' added to " << username << ".\n";
+}
+
+// List users by favorite game
+void listUsersByFavoriteGame(const string &game) {
+    writeUserListing(standardOutput(), "Users who like " + game, games.usersWith(game), graph, roles,
+                     "No users found who like this game.");
+}
+
+// Add aim in life for a user
+void addAimInLife(const string &username, const string &aim) {
+    uint32_t id = graph.findUser(username);
+    if (id == GraphCore::npos) {
+        cout << username << " is not registered in the network.\n";
+        return;
+    }
+    setAttribute("aim", aims, id, aim);
+    logMutation(LogSetAttribute, {"aim", username, aim});
+    cout << "Aim in life '" << aim << "' added to " << username << ".\n";
+}
+
+// List users by aim in life
+void listUsersByAim(const string &aim) {
+    writeUserListing(standardOutput(), "Users who want to be a " + aim, aims.usersWith(aim), graph, roles,
+                     "No users found with this aim in life.");
+}
+
+
+    // Display the entire network
+    void displayNetwork() {
+        OutputBuffer &out = standardOutput();
+        out << "\n--- Network Overview ---\n";
+        for (uint32_t user = 0; user < graph.userCount(); ++user) {
+            out << graph.nameOf(user) << " (" << departments.valueOf(user) << ", " << roles.valueOf(user) << "): ";
+            for (uint32_t conn : graph.neighbors(user)) {
+                out << graph.nameOf(conn) << " ";
+            }
+            out << "\n";
+            out.flushIfFull();
+        }
+        out << "-------------------------\n";
+    }
+
+    // Export the network structure to a DOT file
+    void exportToDotFile(const string &filename) {
+        OutputBuffer dotFile;
+        if (!dotFile.open(filename)) {
+            standardOutput() << "Unable to create DOT file.\n";
+            return;
+        }
+
+        writeDotGraph(dotFile, view());
+        dotFile.close();
+
+        standardOutput() << "Graph exported to " << filename << ". Use Graphviz or similar tools to visualize it.\n";
+    }
+
+    // Export every department's subgraph to its own DOT file
+    void exportGraphsByDepartment(const string &outputDir) {
+        OutputBuffer &out = standardOutput();
+        for (const auto &[filename, written] : exportDepartmentGraphs(outputDir)) {
+            out << (written ? "Exported: " : "Could not open file: ") << filename << "\n";
+        }
+    }
+
+    // List users in a specific department
+    void listUsersInDepartment(const string &department) {
+        printCached("listUsersInDepartment\t" + department, [&](OutputBuffer &text) {
+            writeUserListing(text, "Users in Department: " + department, departments.usersWith(department), graph,
+                             roles, "No users found in this department.");
+            return vector<CacheDependency>{{CacheDependency::Attribute, attributeKey("department", department)},
+                                           {CacheDependency::Attribute, attributeKey("role")}};
+        });
+    }
+
+    // List users holding a specific role
+    void listUsersByRole(const string &role) {
+        writeUserListing(standardOutput(), "Users with Role: " + role, roles.usersWith(role), graph, departments,
+                         "No users found with this role.");
+    }
+
+    // Suggest up to k connections ranked by mutual friends (k = 0 lists all)
+    void suggestConnections(const string &username, size_t k) {
+        uint32_t id = graph.findUser(username);
+        if (id == GraphCore::npos) {
+            standardOutput() << username << " is not registered in the network.\n";
+            return;
+        }
+
+        printCached("suggestConnections\t" + username + "\t" + to_string(k), [&](OutputBuffer &text) {
+            vector<Suggestion> connectionSuggestions = suggestionsFor(id, k);
+            text << "\n--- Connection Suggestions for " << username << " ---\n";
+            for (const Suggestion &suggestion : connectionSuggestions) {
+                text << graph.nameOf(suggestion.user) << " (" << suggestion.mutualCount << " mutual connections)\n";
+            }
+            text << "-------------------------------------------\n";
+            return suggestionDependencies(id);
+        });
+    }
+
+    // Show the connections two users share; `attribute` other than "all"
+    // keeps only those with the same value of it as user1
+    void showMutualConnections(const string &user1, const string &user2, const string &attribute) {
+        OutputBuffer &out = standardOutput();
+        uint32_t id1 = graph.findUser(user1);
+        uint32_t id2 = graph.findUser(user2);
+        if (id1 == GraphCore::npos || id2 == GraphCore::npos) {
+            out << "Both users must be registered to compare connections.\n";
+            return;
+        }
+        const AttributeIndex *filter = attribute == "all" ? nullptr : attributeNamed(attribute);
+        if (attribute != "all" && filter == nullptr) {
+            out << "Unknown filter " << attribute << ".\n";
+            return;
+        }
+
+        vector<uint32_t> mutual = findMutualConnections(id1, id2, filter);
+        out << "\n--- Mutual Connections of " << user1 << " and " << user2 << " ---\n";
+        for (uint32_t user : mutual) {
+            out << graph.nameOf(user) << " (" << departments.valueOf(user) << ", " << roles.valueOf(user) << ")\n";
+        }
+        if (mutual.empty()) {
+            out << "No mutual connections found.\n";
+        }
+        out << "-------------------------------------------\n";
+    }
+
+    // Find the shortest path between two users using bidirectional BFS
+    void findShortestPath(const string &startUser, const string &endUser) {
+        uint32_t start = graph.findUser(startUser);
+        uint32_t end = graph.findUser(endUser);
+        if (start == GraphCore::npos || end == GraphCore::npos) {
+            standardOutput() << "Both users must be registered to find a connection path.\n";
+            return;
+        }
+
+        printCached("findShortestPath\t" + startUser + "\t" + endUser, [&](OutputBuffer &text) {
+            vector<uint32_t> path = shortestPath(start, end);
+            if (path.empty()) {
+                text << "No path exists between " << startUser << " and " << endUser << ".\n";
+            } else {
+                text << "\n--- Shortest Path from " << startUser << " to " << endUser << " ---\n";
+                for (uint32_t node : path) {
+                    text << graph.nameOf(node) << (node == end ? "\n" : " -> ");
+                }
+            }
+            return pathDependencies(start, end);
+        });
+    }
+
+    // Estimate how two users are connected: distance bounds and a candidate
+    // path from the landmark index, or the exact answer if there is no index
+    void showConnectionEstimate(const string &startUser, const string &endUser) {
+        OutputBuffer &out = standardOutput();
+        uint32_t start = graph.findUser(startUser);
+        uint32_t end = graph.findUser(endUser);
+        if (start == GraphCore::npos || end == GraphCore::npos) {
+            out << "Both users must be registered to estimate a connection.\n";
+            return;
+        }
+
+        vector<uint32_t> path;
+        DistanceEstimate estimate = estimateDistance(start, end, path);
+        if (path.empty()) {
+            out << "No path exists between " << startUser << " and " << endUser << ".\n";
+            return;
+        }
+        out << "\n--- Estimated Connection from " << startUser << " to " << endUser << " ---\n";
+        if (estimate.exact()) {
+            out << "Distance: " << estimate.upper << " hop(s)\n";
+        } else {
+            out << "Distance: between " << estimate.lower << " and " << estimate.upper << " hop(s)\n";
+        }
+        out << "Path: ";
+        for (size_t i = 0; i < path.size(); ++i) {
+            out << graph.nameOf(path[i]) << (i + 1 == path.size() ? "\n" : " -> ");
+        }
+        out << "-------------------------------------------\n";
+    }
+
+    // Summarise the connected components: how many there are, the largest
+    // ones with one member each, and how many users have no connections
+    void showComponentSummary(size_t shown = 10) {
+        OutputBuffer &out = standardOutput();
+        vector<uint32_t> roots = graph.componentRoots();
+        size_t isolated = 0;
+        for (uint32_t root : roots) {
+            isolated += graph.componentSize(root) == 1;
+        }
+
+        out << "\n--- Connected Components ---\n";
+        out << graph.userCount() << " users in " << roots.size() << " component(s)\n";
+        for (size_t i = 0; i < roots.size() && i < shown && graph.componentSize(roots[i]) > 1; ++i) {
+            out << i + 1 << ". " << graph.componentSize(roots[i]) << " users, including " << graph.nameOf(roots[i])
+                << "\n";
+        }
+        if (isolated > 0) {
+            out << isolated << " user(s) have no connections\n";
+        }
+        if (!roots.empty() && graph.componentSize(roots[0]) > 1) {
+            out << "Diameter of the largest component: at least " << diameterLowerBound(graph, roots[0]) << "\n";
+        }
+        out << "-------------------------------------------\n";
+    }
+
+    // Count everyone within k hops of a user, per hop; optionally list them too
+    void showNeighborhood(const string &username, uint32_t k, bool listUsers) {
+        OutputBuffer &out = standardOutput();
+        uint32_t id = graph.findUser(username);
+        if (id == GraphCore::npos) {
+            out << username << " is not registered in the network.\n";
+            return;
+        }
+
+        HopNeighborhood hood = kHopNeighborhood(graph, id, k, listUsers);
+        out << "\n--- Users Within " << k << " Hops of " << username << " ---\n";
+        for (size_t hop = 0; hop < hood.counts.size(); ++hop) {
+            out << "Hop " << hop + 1 << ": " << hood.counts[hop] << " user(s)";
+            if (listUsers) {
+                out << ":";
+                for (uint32_t user : hood.ids[hop]) {
+                    out << " " << graph.nameOf(user);
+                }
+            }
+            out << "\n";
+        }
+        out << "Total: " << hood.total() << " user(s)\n";
+        out << "-------------------------------------------\n";
+    }
+
+    // Hop distances from one user to everyone else (parallel BFS over the whole graph)
+    void showDistanceProfile(const string &username) {
+        OutputBuffer &out = standardOutput();
+        uint32_t id = graph.findUser(username);
+        if (id == GraphCore::npos) {
+            out << username << " is not registered in the network.\n";
+            return;
+        }
+
+        ParallelBfs bfs;
+        bfs.run(graph, id);
+        out << "\n--- Distance Profile of " << username << " ---\n";
+        const vector<uint64_t> &levels = bfs.levelSizes();
+        for (size_t distance = 1; distance < levels.size(); ++distance) {
+            out << distance << " hop(s): " << levels[distance] << " user(s)\n";
+        }
+        out << "Eccentricity: " << bfs.eccentricity() << "\n";
+        out << "Unreachable: " << graph.userCount() - bfs.reachableCount() << " user(s)\n";
+        out << "-------------------------------------------\n";
+    }
+
+
+    // Hit and miss counts of the query result cache
+    void showCacheStatistics() {
+        OutputBuffer &out = standardOutput();
+        uint64_t lookups = resultCache.hits() + resultCache.misses();
+        out << "\n--- Query Cache ---\n";
+        out << "Hits: " << resultCache.hits() << "\n";
+        out << "Misses: " << resultCache.misses() << " (" << resultCache.staleDrops() << " expired by changes)\n";
+        out << "Hit rate: " << (lookups > 0 ? 100.0 * resultCache.hits() / lookups : 0.0) << "%\n";
+        out << "Entries: " << resultCache.size() << " (" << resultCache.bytes() / 1024 << " KiB)\n";
+        out << "-------------------------------------------\n";
+    }
+};
+
+// Function to visualize the network graph
+void visualizeNetwork(const GraphView& graph, const vector<LayoutPoint>& layout) {
+    vector<sf::Vector2f> positions;
+    positions.reserve(graph.userCount());
+    for (uint32_t user = 0; user < graph.userCount(); ++user) {
+        positions.emplace_back(layout[user].x, layout[user].y);
+    }
+
+    NetworkRenderer renderer;
+    renderer.setScene(graph, move(positions));
+    renderer.run("Social Network Visualizer");
+}
+
+// Command-line modes; without arguments the interactive menu runs
+void printUsage(ostream &out) {
+    out << "Usage: social_networking4 [mode]\n"
+        << "  --batch FILE                  run the commands in FILE (- for standard input)\n"
+        << "  --precompute-suggestions K    rank the top K suggestions of every user (0 keeps all)\n"
+        << "  --build-landmarks N           index distances from N landmark users\n"
+        << "  --layout                      compute and cache the visualizer layout\n"
+        << "  --render FILE [WIDTH]         draw the network to a .png, .svg or .ppm file\n"
+        << "  --help                        show this message\n";
+}
+
+int main(int argc, char *argv[]) {
+    // Check the arguments before any data is loaded
+    string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--help" || mode == "-h") {
+        printUsage(cout);
+        return 0;
+    }
+    bool known = argc == 1 || (argc == 2 && mode == "--layout") || ((argc == 3 || argc == 4) && mode == "--render") ||
+                 (argc == 3 && (mode == "--batch" || mode == "--precompute-suggestions" || mode == "--build-landmarks"));
+    const char *number = nullptr; // the mode's numeric argument, if it has one
+    if (known && (mode == "--precompute-suggestions" || mode == "--build-landmarks")) {
+        number = argv[2];
+    } else if (known && mode == "--render" && argc == 4) {
+        number = argv[3];
+    }
+    size_t count = 0;
+    if (!known || (number != nullptr && !parseCount(number, count))) {
+        if (known) {
+            cerr << "Invalid number " << number << " for " << mode << "\n";
+        } else {
+            cerr << "Unknown arguments\n";
+        }
+        printUsage(cerr);
+        return 1;
+    }
+
+    NetworkManager manager;
+    string snapshotName = "network_data.snap";
+    string logName = "network_data.wal";
+    string suggestionName = "network_data.sugg";
+    string landmarkName = "network_data.lmk";
+    string layoutName = "network_data.layout";
+    string fileName = "network_data.txt";
+    if (!manager.openStorage(snapshotName, logName, suggestionName, landmarkName, layoutName)) {
+        manager.loadUserData(fileName);
+        manager.saveNetwork();
+    }
+    if (argc == 3 && string(argv[1]) == "--batch") {
+        manager.runBatch(argv[2]);
+        return 0;
+    }
+    if (argc == 3 && string(argv[1]) == "--precompute-suggestions") {
+        manager.precomputeAllSuggestions(count);
+        return 0;
+    }
+    if (argc == 3 && string(argv[1]) == "--build-landmarks") {
+        manager.buildLandmarks(count, LandmarkSelection::Degree);
+        return 0;
+    }
+    if (argc == 2 && string(argv[1]) == "--layout") {
+        manager.networkLayout();
+        return 0;
+    }
+    if ((argc == 3 || argc == 4) && string(argv[1]) == "--render") {
+        manager.renderNetworkImage(argv[2], argc == 4 ? static_cast<unsigned>(min<size_t>(count, UINT32_MAX))
+                                                       : ImageOptions().width);
+        return 0;
+    }
+
+    int choice;
+    size_t limit;
+    string user1, user2, department, role;
+    string game;
+    string interest;
+    string aim;
+
+    while (true) {
+        cout << "\n--- Network Management Menu ---\n";
+        cout << "1. Register User\n";
+        cout << "2. Add Connection\n";
+        cout << "3. Display Network\n";
+        cout << "4. List Users by Department\n";
+        cout << "5. Suggest Connections\n";
+        cout << "6. Find Shortest Path\n";
+        cout << "7. Export Graph\n";
+        cout << "8. Visualize Network\n";
+        cout<<"9.list users by department\n";
+        cout<<"10.list users by interest\n";
+        cout<<"11.list users by aim\n";
+        cout << "12. Save and Exit\n";
+        cout << "13. List Users by Favorite Game\n";
+        cout << "14. List Users by Role\n";
+        cout << "15. Bulk Import Users and Connections\n";
+        cout << "16. Precompute Suggestions for All Users\n";
+        cout << "17. Show Mutual Connections\n";
+        cout << "18. Show Connected Components\n";
+        cout << "19. Show Users Within K Hops\n";
+        cout << "20. Show Distance Profile\n";
+        cout << "21. Estimate Connection Between Users\n";
+        cout << "22. Build Landmark Index\n";
+        cout << "23. Show Query Cache Statistics\n";
+        cout << "24. Export Graphs by Department\n";
+        cout << "25. Render Network Image\n";
+        cout << "Enter your choice: ";
+        if (!(cin >> choice)) {
+            // End of input: everything is already in the log
+            return 0;
+        }
+
+        switch (choice) {
+        case 1:
+            cout << "Enter username: ";
+            cin >> user1;
+            cout << "Enter department: ";
+            cin >> department;
+            cout << "Enter role (e.g., student/teacher): ";
+            cin >> role;
+            cout << "Enter field of interest (e.g., AI, Business, Economics): ";
+            cin >> interest;
+            cout << "Enter favorite game (e.g., Football, Chess): ";
+            cin >> game;
+            cout << "Enter aim in life (e.g., Doctor, Engineer, Entrepreneur): ";
+            cin >> aim;
+            manager.registerUser(user1, department, role, interest, game, aim);
+            break;
+            
+        case 2:
+            cout << "Enter first user: ";
+            cin >> user1;
+            cout << "Enter second user: ";
+            cin >> user2;
+            manager.addConnection(user1, user2);
+            break;
+        case 3:
+            manager.displayNetwork();
+            break;
+        case 4:
+            cout << "Enter department: ";
+            cin >> department;
+            manager.listUsersInDepartment(department);
+            break;
+        case 5:
+            cout << "Enter username for suggestions: ";
+            cin >> user1;
+            cout << "How many suggestions (0 for all): ";
+            cin >> limit;
+            manager.suggestConnections(user1, limit);
+            break;
+        case 6:
+            cout << "Enter start user: ";
+            cin >> user1;
+            cout << "Enter end user: ";
+            cin >> user2;
+            manager.findShortestPath(user1, user2);
+            break;
+        case 7:
+            cout << "Enter filename to export graph (e.g., graph.dot): ";
+            cin >> user1;
+            manager.exportToDotFile(user1);
+            break;
+        case 8:
+            cout<<"Visualize Network\n";
+            visualizeNetwork(manager.view(), manager.networkLayout());
+
+            cout<<"...............................";
+            break;
+    case 9:
+        cout << "Enter department to search: ";
+
+        cin >> department;
+
+        manager.listUsersInDepartment(department);
+        break;
+
+    case 10:
+        cout << "Enter field of interest to search: ";
+        cin >> interest;
+        manager.listUsersByFieldOfInterest(interest);
+        break;
+
+    case 11:
+        cout << "Enter aim in life to search: ";
+        cin >> aim;
+        manager.listUsersByAim(aim);
+        break;
+
+        case 12:
+            if (!manager.saveNetwork()) {
+                cout << "Unable to write " << snapshotName << ".\n";
+                break;
+            }
+            cout << "Data saved. Exiting...\n";
+            return 0;
+        case 13:
+            cout << "Enter favorite game to search: ";
+            cin >> game;
+            manager.listUsersByFavoriteGame(game);
+            break;
+        case 14:
+            cout << "Enter role to search: ";
+            cin >> role;
+            manager.listUsersByRole(role);
+            break;
+        case 15:
+            cout << "Enter user file (or - to skip): ";
+            cin >> user1;
+            cout << "Enter edge-list file (or - to skip): ";
+            cin >> user2;
+            manager.bulkImport(user1, user2);
+            break;
+        case 16:
+            cout << "Suggestions to keep per user (0 for all): ";
+            cin >> limit;
+            manager.precomputeAllSuggestions(limit);
+            break;
+        case 17:
+            cout << "Enter first username: ";
+            cin >> user1;
+            cout << "Enter second username: ";
+            cin >> user2;
+            cout << "Filter by (all/department/role/interest/game/aim): ";
+            cin >> department;
+            manager.showMutualConnections(user1, user2, department);
+            break;
+        case 18:
+            manager.showComponentSummary();
+            break;
+        case 19:
+            cout << "Enter username: ";
+            cin >> user1;
+            cout << "Number of hops: ";
+            cin >> limit;
+            cout << "List the users too (y/n): ";
+            cin >> user2;
+            manager.showNeighborhood(user1, static_cast<uint32_t>(min<size_t>(limit, UINT32_MAX)), user2 == "y");
+            break;
+        case 20:
+            cout << "Enter username: ";
+            cin >> user1;
+            manager.showDistanceProfile(user1);
+            break;
+        case 21:
+            cout << "Enter first user: ";
+            cin >> user1;
+            cout << "Enter second user: ";
+            cin >> user2;
+            manager.showConnectionEstimate(user1, user2);
+            break;
+        case 22:
+            cout << "Number of landmarks: ";
+            cin >> limit;
+            cout << "Choose landmarks by (degree/random): ";
+            cin >> user1;
+            manager.buildLandmarks(limit, user1 == "random" ? LandmarkSelection::Random : LandmarkSelection::Degree);
+            break;
+        case 23:
+            manager.showCacheStatistics();
+            break;
+        case 24:
+            cout << "Enter output directory: ";
+            cin >> user1;
+            manager.exportGraphsByDepartment(user1);
+            break;
+        case 25:
+            cout << "Enter image file (.png, .svg or .ppm): ";
+            cin >> user1;
+            cout << "Image width in pixels: ";
+            cin >> limit;
+            manager.renderNetworkImage(user1, static_cast<unsigned>(min<size_t>(limit, UINT32_MAX)));
+            break;
+        default:
+            cout << "Invalid option. Please try again.\n";
+        }
+        standardOutput().flush();
+    }
+}
@@ -1,569 +1,1808 @@
-// File: network_manager.c
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-#define MAX_USERS 100
-#define MAX_CONNECTIONS 100
-#define MAX_LEN 50
-
-typedef struct {
-    char username[MAX_LEN];
-    char department[MAX_LEN];
-    char role[MAX_LEN];
-    char interest[MAX_LEN];
-    char game[MAX_LEN];
-    char aim[MAX_LEN];
-    char connections[MAX_CONNECTIONS][MAX_LEN];
-    int connectionCount;
-} User;
-
-User users[MAX_USERS];
-int userCount = 0;
-
-// Utility: Find index of user
-int findUserIndex(const char *username) {
-    for (int i = 0; i < userCount; ++i) {
-        if (strcmp(users[i].username, username) == 0) return i;
-    }
-    return -1;
-}
-
-// Load user data from file
-void loadUserData(const char *filename) {
-    FILE *file = fopen(filename, "r");
-    if (!file) return;
-
-    char uname[MAX_LEN], dept[MAX_LEN], role[MAX_LEN];
-    while (fscanf(file, "%s %s %s", uname, dept, role) == 3) {
-        strcpy(users[userCount].username, uname);
-        strcpy(users[userCount].department, dept);
-        strcpy(users[userCount].role, role);
-        users[userCount].connectionCount = 0;
-        userCount++;
-    }
-    fclose(file);
-}
-
-// Save user data to file
-void saveUserData(const char *filename) {
-    FILE *file = fopen(filename, "w");
-    for (int i = 0; i < userCount; ++i) {
-        fprintf(file, "%s %s %s\n", users[i].username, users[i].department, users[i].role);
-    }
-    fclose(file);
-}
-
-// Register new user
-void registerUser(const char *uname, const char *dept, const char *role,
-                  const char *interest, const char *game, const char *aim) {
-    if (findUserIndex(uname) != -1) {
-        printf("%s is already registered.\n", uname);
-        return;
-    }
-    if (userCount >= MAX_USERS) {
-        printf("User limit reached.\n");
-        return;
-    }
-
-    strcpy(users[userCount].username, uname);
-    strcpy(users[userCount].department, dept);
-    strcpy(users[userCount].role, role);
-    strcpy(users[userCount].interest, interest);
-    strcpy(users[userCount].game, game);
-    strcpy(users[userCount].aim, aim);
-    users[userCount].connectionCount = 0;
-
-    userCount++;
-    printf("%s has been successfully registered.\n", uname);
-}
-
-// Add connection between users
-void addConnection(const char *user1, const char *user2) {
-    if (strcmp(user1, user2) == 0) {
-        printf("A user cannot connect with themselves.\n");
-        return;
-    }
-
-    int idx1 = findUserIndex(user1);
-    int idx2 = findUserIndex(user2);
-    if (idx1 == -1 || idx2 == -1) {
-        printf("Both users must be registered to connect.\n");
-        return;
-    }
-
-    for (int i = 0; i < users[idx1].connectionCount; i++) {
-        if (strcmp(users[idx1].connections[i], user2) == 0) {
-            printf("%s and %s are already connected.\n", user1, user2);
-            return;
-        }
-    }
-
-    strcpy(users[idx1].connections[users[idx1].connectionCount++], user2);
-    strcpy(users[idx2].connections[users[idx2].connectionCount++], user1);
-    printf("Connection established between %s and %s.\n", user1, user2);
-}
-
-// Display network
-void displayNetwork() {
-    printf("\n--- Network Overview ---\n");
-    for (int i = 0; i < userCount; i++) {
-        printf("%s is connected to: ", users[i].username);
-        for (int j = 0; j < users[i].connectionCount; j++) {
-            printf("%s ", users[i].connections[j]);
-        }
-        printf("\n");
-    }
-    printf("-------------------------\n");
-}
-
-#include <stdbool.h>
-
-void listUsersByDepartment(const char *department) {
-    printf("--- Users in Department: %s ---\n", department);
-    bool found = false;
-    for (int i = 0; i < userCount; ++i) {
-        if (strcmp(users[i].department, department) == 0) {
-            printf("%s (%s)\n", users[i].username, users[i].role);
-            found = true;
-        }
-    }
-    if (!found) printf("No users found in this department.\n");
-    printf("--------------------------------\n");
-}
-
-void listUsersByAim(const char *aim) {
-    printf("--- Users who aim to be a %s ---\n", aim);
-    bool found = false;
-    for (int i = 0; i < userCount; ++i) {
-        if (strcmp(users[i].aim, aim) == 0) {
-            printf("%s (%s)\n", users[i].username, users[i].role);
-            found = true;
-        }
-    }
-    if (!found) printf("No users found with this aim.\n");
-    printf("--------------------------------\n");
-}
-
-void listUsersByInterest(const char *interest) {
-    printf("--- Users interested in %s ---\n", interest);
-    bool found = false;
-    for (int i = 0; i < userCount; ++i) {
-        if (strcmp(users[i].interest, interest) == 0) {
-            printf("%s (%s)\n", users[i].username, users[i].role);
-            found = true;
-        }
-    }
-    if (!found) printf("No users found with this interest.\n");
-    printf("--------------------------------\n");
-}
-
-bool areConnected(const char *user1, const char *user2) {
-    int idx1 = findUserIndex(user1);
-    for (int i = 0; i < users[idx1].connectionCount; ++i) {
-        if (strcmp(users[idx1].connections[i], user2) == 0) return true;
-    }
-    return false;
-}
-
-void suggestConnections(const char *userId) {
-    int idx = findUserIndex(userId);
-    if (idx == -1) {
-        printf("User not found.\n");
-        return;
-    }
-
-    int suggestions[MAX_USERS] = {0};
-    for (int i = 0; i < users[idx].connectionCount; ++i) {
-        int friendIdx = findUserIndex(users[idx].connections[i]);
-        for (int j = 0; j < users[friendIdx].connectionCount; ++j) {
-            const char *fof = users[friendIdx].connections[j];
-            int fofIdx = findUserIndex(fof);
-            if (strcmp(fof, userId) != 0 && !areConnected(userId, fof)) {
-                suggestions[fofIdx]++;
-            }
-        }
-    }
-
-    printf("--- Suggested Connections for %s ---\n", userId);
-    bool found = false;
-    for (int i = 0; i < userCount; ++i) {
-        if (suggestions[i] > 0) {
-            printf("%s (%d mutual connection(s))\n", users[i].username, suggestions[i]);
-            found = true;
-        }
-    }
-    if (!found) printf("No suggestions available.\n");
-    printf("--------------------------------\n");
-}
-
-void findShortestPath(const char *start, const char *end) {
-    int startIdx = findUserIndex(start);
-    int endIdx = findUserIndex(end);
-    if (startIdx == -1 || endIdx == -1) {
-        printf("One or both users not found.\n");
-        return;
-    }
-
-    int visited[MAX_USERS] = {0}, parent[MAX_USERS];
-    for (int i = 0; i < MAX_USERS; ++i) parent[i] = -1;
-
-    int queue[MAX_USERS], front = 0, rear = 0;
-    queue[rear++] = startIdx;
-    visited[startIdx] = 1;
-
-    while (front < rear) {
-        int curr = queue[front++];
-        for (int i = 0; i < users[curr].connectionCount; ++i) {
-            int neighborIdx = findUserIndex(users[curr].connections[i]);
-            if (!visited[neighborIdx]) {
-                visited[neighborIdx] = 1;
-                parent[neighborIdx] = curr;
-                queue[rear++] = neighborIdx;
-                if (neighborIdx == endIdx) break;
-            }
-        }
-    }
-
-    if (parent[endIdx] == -1) {
-        printf("No path found between %s and %s.\n", start, end);
-        return;
-    }
-
-    // Trace path
-    int path[MAX_USERS], length = 0;
-    for (int at = endIdx; at != -1; at = parent[at])
-        path[length++] = at;
-
-    printf("--- Shortest Path from %s to %s ---\n", start, end);
-    for (int i = length - 1; i >= 0; --i) {
-        printf("%s", users[path[i]].username);
-        if (i != 0) printf(" -> ");
-    }
-    printf("\n--------------------------------\n");
-}
-void showMutualFriendsByFilter(const char *user1, const char *user2, const char *filterType) {
-    int idx1 = findUserIndex(user1);
-    int idx2 = findUserIndex(user2);
-
-    if (idx1 == -1 || idx2 == -1) {
-        printf("One or both users not found.\n");
-        return;
-    }
-
-    printf("--- Mutual Friends Between %s and %s (Filtered by %s) ---\n", user1, user2, filterType);
-    bool found = false;
-
-    for (int i = 0; i < users[idx1].connectionCount; ++i) {
-        const char *conn = users[idx1].connections[i];
-
-        // Check if also connected to user2
-        if (areConnected(user2, conn)) {
-            int mutualIdx = findUserIndex(conn);
-
-            if (strcmp(filterType, "department") == 0 &&
-                strcmp(users[mutualIdx].department, users[idx1].department) == 0) {
-                printf("%s (%s, %s)\n", conn, users[mutualIdx].role, users[mutualIdx].department);
-                found = true;
-            } else if (strcmp(filterType, "interest") == 0 &&
-                       strcmp(users[mutualIdx].interest, users[idx1].interest) == 0) {
-                printf("%s (%s, %s)\n", conn, users[mutualIdx].role, users[mutualIdx].interest);
-                found = true;
-            } else if (strcmp(filterType, "aim") == 0 &&
-                       strcmp(users[mutualIdx].aim, users[idx1].aim) == 0) {
-                printf("%s (%s, %s)\n", conn, users[mutualIdx].role, users[mutualIdx].aim);
-                found = true;
-            }
-        }
-    }
-
-    if (!found)
-        printf("No mutual friends match the given filter.\n");
-
-    printf("--------------------------------\n");
-}
-
-
-void showAdjacencyMatrix() {
-    printf("--- Adjacency Matrix ---\n     ");
-    for (int i = 0; i < userCount; ++i)
-        printf("%-10s", users[i].username);
-    printf("\n");
-
-    for (int i = 0; i < userCount; ++i) {
-        printf("%-5s", users[i].username);
-        for (int j = 0; j < userCount; ++j) {
-            printf("%-10d", areConnected(users[i].username, users[j].username));
-        }
-        printf("\n");
-    }
-    printf("--------------------------------\n");
-}
-
-#include <sys/stat.h> // for mkdir on Unix systems
-
-// Export Graphs by Department
-void exportGraphsByDepartment(const char *outputDir) {
-#ifdef _WIN32
-    mkdir(outputDir);
-#else
-    mkdir(outputDir, 0755);
-#endif
-
-    for (int i = 0; i < userCount; ++i) {
-        const char *dept = users[i].department;
-
-        // Check if already exported for this department
-        char filename[256];
-        snprintf(filename, sizeof(filename), "%s/%s_graph.dot", outputDir, dept);
-
-        FILE *dotFile = fopen(filename, "w");
-        
-        if (!dotFile) {
-            printf("Could not open file: %s\n", filename);
-            continue;
-        }
-
-        fprintf(dotFile, "graph \"%s_Network\" {\n", dept);
-        fprintf(dotFile, "  node [shape=ellipse, style=filled, fillcolor=lightyellow];\n");
-
-        // Add department nodes
-        for (int j = 0; j < userCount; ++j) {
-            if (strcmp(users[j].department, dept) == 0) {
-                fprintf(dotFile, "  \"%s\" [label=\"%s\\n%s\\n%s\\n%s\"];\n",
-                        users[j].username,
-                        users[j].username,
-                        users[j].role,
-                        users[j].interest,
-                        users[j].game);
-            }
-        }
-
-        // Add department connections
-        for (int j = 0; j < userCount; ++j) {
-            if (strcmp(users[j].department, dept) != 0) continue;
-
-            for (int k = 0; k < users[j].connectionCount; ++k) {
-                int connIdx = findUserIndex(users[j].connections[k]);
-                if (connIdx == -1 || strcmp(users[connIdx].department, dept) != 0) continue;
-                if (strcmp(users[j].username, users[connIdx].username) < 0) {
-                    fprintf(dotFile, "  \"%s\" -- \"%s\";\n",
-                            users[j].username, users[connIdx].username);
-                }
-            }
-        }
-
-        fprintf(dotFile, "}\n");
-        fclose(dotFile);
-        printf("Exported: %s\n", filename);
-    }
-}
-
-void exportMutualHighlightGraph(const char *user1, const char *user2, const char *filename) {
-    int idx1 = findUserIndex(user1);
-    int idx2 = findUserIndex(user2);
-
-    if (idx1 == -1 || idx2 == -1) {
-        printf("One or both users not found.\n");
-        return;
-    }
-
-    FILE *dotFile = fopen(filename, "w");
-    if (!dotFile) {
-        printf("Unable to create DOT file.\n");
-        return;
-    }
-
-    fprintf(dotFile, "graph MutualHighlight {\n");
-
-    fprintf(dotFile, "  node [shape=ellipse, style=filled, fillcolor=white];\n");
-
-    // Declare all users
-    for (int i = 0; i < userCount; ++i) {
-        fprintf(dotFile, "  \"%s\";\n", users[i].username);
-    }
-
-    // Highlight mutual friends
-    for (int i = 0; i < users[idx1].connectionCount; ++i) {
-        const char *conn = users[idx1].connections[i];
-        if (areConnected(user2, conn)) {
-            fprintf(dotFile, "  \"%s\" [fillcolor=lightgreen];\n", conn);
-
-            fprintf(dotFile, "  \"%s\" -- \"%s\" [color=green, penwidth=2.0];\n", user1, conn);
-
-            fprintf(dotFile, "  \"%s\" -- \"%s\" [color=green, penwidth=2.0];\n", user2, conn);
-        }
-    }
-
-    // Draw all other connections
-    for (int i = 0; i < userCount; ++i) {
-        for (int j = 0; j < users[i].connectionCount; ++j) {
-            const char *u1 = users[i].username;
-            const char *u2 = users[i].connections[j];
-
-            // Avoid duplicate edges
-            if (strcmp(u1, u2) < 0) {
-                if (!(strcmp(u1, user1) == 0 && areConnected(user2, u2))) {
-                    fprintf(dotFile, "  \"%s\" -- \"%s\";\n", u1, u2);
-                }
-            }
-        }
-    }
-
-    fprintf(dotFile, "}\n");
-    fclose(dotFile);
-    printf("Mutual highlight graph exported to %s\n", filename);
-}
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "network_manager.c"  // Make sure this contains all your logic from Parts 1–3
-
-int main() {
-    char user1[MAX_LEN], user2[MAX_LEN];
-    char department[MAX_LEN], role[MAX_LEN];
-    char interest[MAX_LEN], game[MAX_LEN], aim[MAX_LEN];
-    char filterType[MAX_LEN], filename[256];
-
-    int choice;
-    loadUserData("network_data.txt");
-
-    while (1) {
-        printf("\n===== Social Media Graph Analyzer =====\n");
-        printf("1. Register User\n");
-        printf("2. Add Connection\n");
-        printf("3. Display Network\n");
-        printf("4. List Users by Department\n");
-        printf("5. List Users by Aim\n");
-        printf("6. List Users by Interest\n");
-        printf("7. Show Mutual Friends by Filter\n");
-        printf("8. Suggest Connections\n");
-        printf("9. Find Shortest Path\n");
-        printf("10. Export Graphs by Department\n");
-        printf("11. Export Mutual Highlight Graph\n");
-        printf("12. Show Adjacency Matrix\n");
-        printf("13. Visualize User Connection Graph (DOT placeholder)\n");
-        printf("14. Save Data\n");
-        printf("15. Exit\n");
-        printf("Enter your choice: ");
-
-        scanf("%d", &choice);
-        getchar();  // consume newline
-
-        switch (choice) {
-            case 1:
-                printf("Enter username: ");
-                scanf("%s", user1);
-
-                printf("Enter department: ");
-                scanf("%s", department);
-
-                printf("Enter role: ");
-                scanf("%s", role);
-
-                printf("Enter field of interest: (write null if you have no interest in anything) ");
-                scanf("%s", interest);
-
-                printf("Enter favorite game: ");
-                scanf("%s", game);
-
-                printf("Enter aim in life: ");
-                scanf("%s", aim);
-                registerUser(user1, department, role, interest, game, aim);
-                break;
-
-            case 2:
-                printf("Enter first username: ");
-                scanf("%s", user1);
-                printf("Enter second username: ");
-                scanf("%s", user2);
-                addConnection(user1, user2);
-                break;
-
-            case 3:
-                displayNetwork();
-                break;
-
-            case 4:
-                printf("Enter department: ");
-                scanf("%s", department);
-                listUsersByDepartment(department);
-                break;
-
-            case 5:
-                printf("Enter aim: ");
-                scanf("%s", aim);
-                listUsersByAim(aim);
-                break;
-
-            case 6:
-                printf("Enter interest: ");
-                scanf("%s", interest);
-                listUsersByInterest(interest);
-                break;
-
-                case 7:
-                printf("Enter first username: ");
-                scanf("%s", user1);
-                printf("Enter second username: ");
-                scanf("%s", user2);
-                printf("Enter filter type (department/interest/aim): ");
-                scanf("%s", filterType);
-                showMutualFriendsByFilter(user1, user2, filterType);
-                break;
-            
-
-            case 8:
-                printf("Enter username: ");
-                scanf("%s", user1);
-                suggestConnections(user1);
-                break;
-
-            case 9:
-                printf("Enter start user: ");
-                scanf("%s", user1);
-                printf("Enter end user: ");
-                scanf("%s", user2);
-                findShortestPath(user1, user2);
-                break;
-
-            case 10:
-                exportGraphsByDepartment("output");
-                break;
-
-            case 11:
-                printf("Enter first username: ");
-                scanf("%s", user1);
-                printf("Enter second username: ");
-                scanf("%s", user2);
-                printf("Enter filename for output (.dot): ");
-                scanf("%s", filename);
-                exportMutualHighlightGraph(user1, user2, filename);
-                break;
-
-            case 12:
-                showAdjacencyMatrix();
-                break;
-
-            case 13:
-                printf("DOT visual graph placeholder. Use exported .dot files in Graphviz viewer.\n");
-                break;
-
-            case 14:
-                saveUserData("network_data.txt");
-                printf("Data saved.\n");
-                break;
-
-            case 15:
-                saveUserData("network_data.txt");
-                printf("Exiting...\n");
-                return 0;
-
-            default:
-                printf("Invalid choice. Please try again.\n");
-        }
-    }
-
-    return 0;
-}
+// File: network_manager.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+
+#define MAX_LEN 50
+
+// Strings live in the arena and attribute values are shared, so a user is a
+// fixed-size record plus its name and one int per connection
+typedef struct {
+    const char *username;
+    const char *department;
+    const char *role;
+    const char *interest;
+    const char *game;
+    const char *aim;
+    int *connections; // user indices, in the order the connections were made
+    int connectionCount;
+    int connectionCapacity;
+} User;
+
+User *users = NULL;
+int userCount = 0;
+int userCapacity = 0;
+
+// Posting list: every user index holding one attribute value, in ascending order
+typedef struct {
+    const char *value; // shared copy from internString()
+    int *userIdx;
+    int count;
+    int capacity;
+} Posting;
+
+// Open-addressing hash table from attribute value to its posting list
+typedef struct {
+    Posting *slots;
+    int capacity;
+    int size;
+} AttributeIndex;
+
+AttributeIndex departmentIndex, aimIndex, interestIndex;
+
+// Open-addressing hash set of connected user-index pairs (0 marks an empty slot)
+typedef struct {
+    unsigned long long *keys;
+    int capacity;
+    int size;
+} EdgeSet;
+
+EdgeSet edgeSet;
+
+unsigned long hashString(const char *str) {
+    unsigned long hash = 5381;
+    while (*str) hash = hash * 33 + (unsigned char)*str++;
+    return hash;
+}
+
+// ---------------- Storage ----------------
+// Bump allocator for names, attribute values and connection lists: memory is
+// carved from 1 MB blocks that live until exit
+#define ARENA_BLOCK_SIZE (1 << 20)
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t used;
+    size_t size;
+    char data[];
+} ArenaBlock;
+
+ArenaBlock *arena = NULL;
+
+// `size` bytes aligned to `align` (a power of two up to 16), or NULL if out of memory
+void *arenaAlloc(size_t size, size_t align) {
+    size_t offset = arena == NULL ? 0 : (arena->used + align - 1) & ~(align - 1);
+    if (arena == NULL || offset > arena->size || arena->size - offset < size) {
+        size_t blockSize = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+        ArenaBlock *block = malloc(sizeof(ArenaBlock) + blockSize);
+        if (block == NULL) return NULL;
+        block->next = arena;
+        block->used = 0;
+        block->size = blockSize;
+        arena = block;
+        offset = 0;
+    }
+    arena->used = offset + size;
+    return arena->data + offset;
+}
+
+// Copy of str in the arena, or NULL if out of memory
+const char *arenaStrdup(const char *str) {
+    size_t length = strlen(str) + 1;
+    char *copy = arenaAlloc(length, 1);
+    if (copy != NULL) memcpy(copy, str, length);
+    return copy;
+}
+
+// Connection lists hold 4 << c ints for some size class c. A list that
+// fills up moves to a block of the next class and its old block goes on the
+// free list of its class (linked through the blocks' first bytes) for reuse.
+#define LIST_CLASSES 28
+
+void *freeLists[LIST_CLASSES];
+
+int *allocList(int sizeClass) {
+    void *block = freeLists[sizeClass];
+    if (block != NULL) {
+        freeLists[sizeClass] = *(void **)block;
+        return block;
+    }
+    return arenaAlloc(((size_t)4 << sizeClass) * sizeof(int), 16);
+}
+
+void freeList(int *list, int sizeClass) {
+    *(void **)list = freeLists[sizeClass];
+    freeLists[sizeClass] = list;
+}
+
+int listSizeClass(int capacity) {
+    int sizeClass = 0;
+    while ((4 << sizeClass) < capacity) sizeClass++;
+    return sizeClass;
+}
+
+// Open-addressing set of attribute values (NULL marks an empty slot)
+typedef struct {
+    const char **slots;
+    int capacity;
+    int size;
+} StringTable;
+
+StringTable attributeValues;
+
+const char **stringSlot(const char **slots, int capacity, const char *value) {
+    unsigned long i = hashString(value) & (capacity - 1);
+    while (slots[i] != NULL && strcmp(slots[i], value) != 0) {
+        i = (i + 1) & (capacity - 1);
+    }
+    return &slots[i];
+}
+
+// The one arena copy of value shared by every user holding it; NULL if out of memory
+const char *internString(const char *value) {
+    if ((attributeValues.size + 1) * 10 > attributeValues.capacity * 7) {
+        int newCapacity = attributeValues.capacity ? attributeValues.capacity * 2 : 64;
+        const char **newSlots = calloc(newCapacity, sizeof(const char *));
+        if (newSlots == NULL) return NULL;
+        for (int i = 0; i < attributeValues.capacity; ++i) {
+            if (attributeValues.slots[i] != NULL) {
+                *stringSlot(newSlots, newCapacity, attributeValues.slots[i]) = attributeValues.slots[i];
+            }
+        }
+        free(attributeValues.slots);
+        attributeValues.slots = newSlots;
+        attributeValues.capacity = newCapacity;
+    }
+    const char **slot = stringSlot(attributeValues.slots, attributeValues.capacity, value);
+    if (*slot == NULL) {
+        *slot = arenaStrdup(value);
+        if (*slot == NULL) return NULL;
+        attributeValues.size++;
+    }
+    return *slot;
+}
+
+// Open-addressing hash table from username to user index (-1 marks an empty slot)
+typedef struct {
+    int *slots;
+    int capacity;
+} NameIndex;
+
+NameIndex nameIndex;
+
+// Sequential names ("user1", "user2", ...) have neighbouring djb2 hashes, so
+// the hash is scrambled before it picks a slot to avoid long probe runs
+int *nameSlot(int *slots, int capacity, const char *username) {
+    unsigned long long i = (hashString(username) * 0x9E3779B97F4A7C15ULL) >> 32 & (capacity - 1);
+    while (slots[i] != -1 && strcmp(users[slots[i]].username, username) != 0) {
+        i = (i + 1) & (capacity - 1);
+    }
+    return &slots[i];
+}
+
+// Make room for one more user in the user array and the name index
+bool reserveUser(void) {
+    if (userCount == userCapacity) {
+        int newCapacity = userCapacity ? userCapacity * 2 : 64;
+        User *grown = realloc(users, newCapacity * sizeof(User));
+        if (grown == NULL) return false;
+        users = grown;
+        userCapacity = newCapacity;
+    }
+    if ((userCount + 1) * 10 > nameIndex.capacity * 7) {
+        int newCapacity = nameIndex.capacity ? nameIndex.capacity * 2 : 128;
+        int *newSlots = malloc(newCapacity * sizeof(int));
+        if (newSlots == NULL) return false;
+        memset(newSlots, 0xFF, newCapacity * sizeof(int));
+        for (int i = 0; i < userCount; ++i) {
+            *nameSlot(newSlots, newCapacity, users[i].username) = i;
+        }
+        free(nameIndex.slots);
+        nameIndex.slots = newSlots;
+        nameIndex.capacity = newCapacity;
+    }
+    return true;
+}
+
+// Append other to idx's connection list
+bool appendConnection(int idx, int other) {
+    User *user = &users[idx];
+    if (user->connectionCount == user->connectionCapacity) {
+        int newCapacity = user->connectionCapacity ? user->connectionCapacity * 2 : 4;
+        if (newCapacity > (4 << (LIST_CLASSES - 1))) return false;
+        int *grown = allocList(listSizeClass(newCapacity));
+        if (grown == NULL) return false;
+        if (user->connectionCount > 0) {
+            memcpy(grown, user->connections, user->connectionCount * sizeof(int));
+            freeList(user->connections, listSizeClass(user->connectionCapacity));
+        }
+        user->connections = grown;
+        user->connectionCapacity = newCapacity;
+    }
+    user->connections[user->connectionCount++] = other;
+    return true;
+}
+
+// Find the slot for value (empty slot if absent)
+Posting *indexSlot(Posting *slots, int capacity, const char *value) {
+    unsigned long i = hashString(value) & (capacity - 1);
+    while (slots[i].userIdx != NULL && strcmp(slots[i].value, value) != 0) {
+        i = (i + 1) & (capacity - 1);
+    }
+    return &slots[i];
+}
+
+// Double the slot table; false if out of memory
+bool indexGrow(AttributeIndex *index) {
+    int newCapacity = index->capacity ? index->capacity * 2 : 16;
+    Posting *newSlots = calloc(newCapacity, sizeof(Posting));
+    if (newSlots == NULL) return false;
+    for (int i = 0; i < index->capacity; ++i) {
+        if (index->slots[i].userIdx != NULL) {
+            *indexSlot(newSlots, newCapacity, index->slots[i].value) = index->slots[i];
+        }
+    }
+    free(index->slots);
+    index->slots = newSlots;
+    index->capacity = newCapacity;
+    return true;
+}
+
+// Posting list for value, or NULL if no user holds it
+Posting *indexLookup(AttributeIndex *index, const char *value) {
+    if (index->capacity == 0) return NULL;
+    Posting *slot = indexSlot(index->slots, index->capacity, value);
+    return slot->userIdx != NULL ? slot : NULL;
+}
+
+// Append a user to the posting list of value (indices arrive in ascending order);
+// value must be an interned string. False if out of memory (nothing is added).
+bool indexAdd(AttributeIndex *index, const char *value, int userIdx) {
+    if ((index->size + 1) * 10 > index->capacity * 7 && !indexGrow(index)) return false;
+
+    Posting *slot = indexSlot(index->slots, index->capacity, value);
+    if (slot->userIdx == NULL) {
+        int *list = malloc(4 * sizeof(int));
+        if (list == NULL) return false;
+        slot->value = value;
+        slot->capacity = 4;
+        slot->userIdx = list;
+        index->size++;
+    } else if (slot->count == slot->capacity) {
+        int *grown = realloc(slot->userIdx, slot->capacity * 2 * sizeof(int));
+        if (grown == NULL) return false;
+        slot->userIdx = grown;
+        slot->capacity *= 2;
+    }
+    slot->userIdx[slot->count++] = userIdx;
+    return true;
+}
+
+// Key for an unordered pair of user indices; never 0
+unsigned long long edgeKey(int idx1, int idx2) {
+    unsigned long long lo = idx1 < idx2 ? idx1 : idx2, hi = idx1 < idx2 ? idx2 : idx1;
+    return ((lo << 32) | hi) + 1;
+}
+
+unsigned long long *edgeSlot(unsigned long long *keys, int capacity, unsigned long long key) {
+    unsigned long long i = (key * 0x9E3779B97F4A7C15ULL) >> 32 & (capacity - 1);
+    while (keys[i] != 0 && keys[i] != key) {
+        i = (i + 1) & (capacity - 1);
+    }
+    return &keys[i];
+}
+
+// Whether two stored users are connected, in O(1)
+bool hasEdge(int idx1, int idx2) {
+    if (edgeSet.capacity == 0) return false;
+    return *edgeSlot(edgeSet.keys, edgeSet.capacity, edgeKey(idx1, idx2)) != 0;
+}
+
+// Record a connection; adding an existing one changes nothing.
+// False if the set could not grow (nothing is recorded).
+bool edgeSetAdd(int idx1, int idx2) {
+    if ((edgeSet.size + 1) * 10 > edgeSet.capacity * 7) {
+        int newCapacity = edgeSet.capacity ? edgeSet.capacity * 2 : 64;
+        unsigned long long *newKeys = calloc(newCapacity, sizeof(unsigned long long));
+        if (newKeys == NULL) return false;
+        for (int i = 0; i < edgeSet.capacity; ++i) {
+            if (edgeSet.keys[i] != 0) *edgeSlot(newKeys, newCapacity, edgeSet.keys[i]) = edgeSet.keys[i];
+        }
+        free(edgeSet.keys);
+        edgeSet.keys = newKeys;
+        edgeSet.capacity = newCapacity;
+    }
+    unsigned long long *slot = edgeSlot(edgeSet.keys, edgeSet.capacity, edgeKey(idx1, idx2));
+    if (*slot == 0) {
+        *slot = edgeKey(idx1, idx2);
+        edgeSet.size++;
+    }
+    return true;
+}
+
+// Add a newly stored user to every attribute index; false if out of memory,
+// in which case the user is in none of them
+bool indexUser(int idx) {
+    AttributeIndex *indexes[] = {&departmentIndex, &aimIndex, &interestIndex};
+    const char *values[] = {users[idx].department, users[idx].aim, users[idx].interest};
+    for (int i = 0; i < 3; ++i) {
+        if (!indexAdd(indexes[i], values[i], idx)) {
+            while (i-- > 0) indexLookup(indexes[i], values[i])->count--;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Print "name (role)" for every user in a posting list
+bool printPosting(AttributeIndex *index, const char *value) {
+    Posting *posting = indexLookup(index, value);
+    if (posting == NULL) return false;
+    for (int i = 0; i < posting->count; ++i) {
+        printf("%s (%s)\n", users[posting->userIdx[i]].username, users[posting->userIdx[i]].role);
+    }
+    return true;
+}
+
+// Utility: Find index of user
+int findUserIndex(const char *username) {
+    if (nameIndex.capacity == 0) return -1;
+    return *nameSlot(nameIndex.slots, nameIndex.capacity, username);
+}
+
+// Append a user whose name is not taken yet; false if out of memory
+bool storeUser(const char *uname, const char *dept, const char *role,
+               const char *interest, const char *game, const char *aim) {
+    if (!reserveUser()) return false;
+
+    User *user = &users[userCount];
+    user->username = arenaStrdup(uname);
+    user->department = internString(dept);
+    user->role = internString(role);
+    user->interest = internString(interest);
+    user->game = internString(game);
+    user->aim = internString(aim);
+    if (!user->username || !user->department || !user->role || !user->interest || !user->game || !user->aim) {
+        return false;
+    }
+    user->connections = NULL;
+    user->connectionCount = 0;
+    user->connectionCapacity = 0;
+
+    if (!indexUser(userCount)) return false;
+    *nameSlot(nameIndex.slots, nameIndex.capacity, uname) = userCount;
+    userCount++;
+    return true;
+}
+
+// Load user data from file
+void loadUserData(const char *filename) {
+    FILE *file = fopen(filename, "r");
+    if (!file) return;
+
+    char uname[MAX_LEN], dept[MAX_LEN], role[MAX_LEN];
+    while (fscanf(file, "%49s %49s %49s", uname, dept, role) == 3) {
+        if (findUserIndex(uname) == -1 && !storeUser(uname, dept, role, "", "", "")) break;
+    }
+    fclose(file);
+}
+
+// Save user data to file
+void saveUserData(const char *filename) {
+    FILE *file = fopen(filename, "w");
+    for (int i = 0; i < userCount; ++i) {
+        fprintf(file, "%s %s %s\n", users[i].username, users[i].department, users[i].role);
+    }
+    fclose(file);
+}
+
+// Outcome of a mutation, shared by the menu and batch mode
+typedef enum {
+    MUTATION_OK,
+    MUTATION_EXISTS,      // user already registered / users already connected
+    MUTATION_FULL,        // out of memory
+    MUTATION_SELF,        // user connected to themselves
+    MUTATION_UNKNOWN_USER
+} MutationStatus;
+
+// Store a new user without printing anything
+MutationStatus insertUser(const char *uname, const char *dept, const char *role,
+                          const char *interest, const char *game, const char *aim) {
+    if (findUserIndex(uname) != -1) return MUTATION_EXISTS;
+    return storeUser(uname, dept, role, interest, game, aim) ? MUTATION_OK : MUTATION_FULL;
+}
+
+// Register new user
+void registerUser(const char *uname, const char *dept, const char *role,
+                  const char *interest, const char *game, const char *aim) {
+    MutationStatus status = insertUser(uname, dept, role, interest, game, aim);
+    if (status == MUTATION_EXISTS) {
+        printf("%s is already registered.\n", uname);
+    } else if (status == MUTATION_FULL) {
+        printf("Not enough memory to register %s.\n", uname);
+    } else {
+        printf("%s has been successfully registered.\n", uname);
+    }
+}
+
+// Store a connection between two users without printing anything
+MutationStatus connectUsers(const char *user1, const char *user2) {
+    if (strcmp(user1, user2) == 0) return MUTATION_SELF;
+
+    int idx1 = findUserIndex(user1);
+    int idx2 = findUserIndex(user2);
+    if (idx1 == -1 || idx2 == -1) return MUTATION_UNKNOWN_USER;
+
+    if (hasEdge(idx1, idx2)) return MUTATION_EXISTS;
+    if (!appendConnection(idx1, idx2)) return MUTATION_FULL;
+    if (!appendConnection(idx2, idx1)) {
+        users[idx1].connectionCount--;
+        return MUTATION_FULL;
+    }
+    if (!edgeSetAdd(idx1, idx2)) {
+        users[idx1].connectionCount--;
+        users[idx2].connectionCount--;
+        return MUTATION_FULL;
+    }
+    return MUTATION_OK;
+}
+
+// Add connection between users
+void addConnection(const char *user1, const char *user2) {
+    switch (connectUsers(user1, user2)) {
+        case MUTATION_SELF:
+            printf("A user cannot connect with themselves.\n");
+            break;
+        case MUTATION_UNKNOWN_USER:
+            printf("Both users must be registered to connect.\n");
+            break;
+        case MUTATION_EXISTS:
+            printf("%s and %s are already connected.\n", user1, user2);
+            break;
+        case MUTATION_FULL:
+            printf("Not enough memory for the connection.\n");
+            break;
+        default:
+            printf("Connection established between %s and %s.\n", user1, user2);
+    }
+}
+
+// Display network
+void displayNetwork() {
+    printf("\n--- Network Overview ---\n");
+    for (int i = 0; i < userCount; i++) {
+        printf("%s is connected to: ", users[i].username);
+        for (int j = 0; j < users[i].connectionCount; j++) {
+            printf("%s ", users[users[i].connections[j]].username);
+        }
+        printf("\n");
+    }
+    printf("-------------------------\n");
+}
+
+void listUsersByDepartment(const char *department) {
+    printf("--- Users in Department: %s ---\n", department);
+    bool found = printPosting(&departmentIndex, department);
+    if (!found) printf("No users found in this department.\n");
+    printf("--------------------------------\n");
+}
+
+void listUsersByAim(const char *aim) {
+    printf("--- Users who aim to be a %s ---\n", aim);
+    bool found = printPosting(&aimIndex, aim);
+    if (!found) printf("No users found with this aim.\n");
+    printf("--------------------------------\n");
+}
+
+void listUsersByInterest(const char *interest) {
+    printf("--- Users interested in %s ---\n", interest);
+    bool found = printPosting(&interestIndex, interest);
+    if (!found) printf("No users found with this interest.\n");
+    printf("--------------------------------\n");
+}
+
+bool areConnected(const char *user1, const char *user2) {
+    int idx1 = findUserIndex(user1);
+    int idx2 = findUserIndex(user2);
+    return idx1 != -1 && idx2 != -1 && hasEdge(idx1, idx2);
+}
+
+// Per-query arrays with one entry per user, kept between queries so a query
+// costs what it touches rather than O(userCount)
+typedef struct {
+    int *mark;   // == epoch once visited by the current traversal
+    int *parent;
+    int *queue;  // BFS queue, or the candidate list of a suggestion query
+    int *counts; // mutual-connection counts; all zero between queries
+    int capacity;
+    int epoch;
+} QueryScratch;
+
+QueryScratch scratch;
+
+// Size the scratch for the current users; false if out of memory
+bool scratchReserve(void) {
+    if (scratch.capacity >= userCount) return true;
+    free(scratch.mark);
+    free(scratch.parent);
+    free(scratch.queue);
+    free(scratch.counts);
+    scratch.mark = calloc(userCapacity, sizeof(int));
+    scratch.parent = malloc(userCapacity * sizeof(int));
+    scratch.queue = malloc(userCapacity * sizeof(int));
+    scratch.counts = calloc(userCapacity, sizeof(int));
+    scratch.epoch = 0;
+    scratch.capacity = userCapacity;
+    if (!scratch.mark || !scratch.parent || !scratch.queue || !scratch.counts) {
+        scratch.capacity = 0;
+        return false;
+    }
+    return true;
+}
+
+// Start a traversal: every mark left by earlier ones becomes stale
+int scratchNextEpoch(void) {
+    if (scratch.epoch == INT_MAX) {
+        memset(scratch.mark, 0, scratch.capacity * sizeof(int));
+        scratch.epoch = 0;
+    }
+    return ++scratch.epoch;
+}
+
+// Count mutual connections with every friend-of-friend not yet connected to
+// idx. counts[] must be all zero on entry; each counted user is appended to
+// candidates[] once and the number of candidates is returned. The caller
+// zeroes counts[] of the candidates again when done.
+int countSuggestions(int idx, int *counts, int *candidates) {
+    int candidateCount = 0;
+    for (int i = 0; i < users[idx].connectionCount; ++i) {
+        int friendIdx = users[idx].connections[i];
+        for (int j = 0; j < users[friendIdx].connectionCount; ++j) {
+            int fofIdx = users[friendIdx].connections[j];
+            if (fofIdx != idx && !hasEdge(idx, fofIdx) && counts[fofIdx]++ == 0) {
+                candidates[candidateCount++] = fofIdx;
+            }
+        }
+    }
+    return candidateCount;
+}
+
+static const int *sortCounts; // qsort has no context argument
+
+// More mutual connections first, then registration order
+static int compareSuggestions(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    if (sortCounts[x] != sortCounts[y]) return sortCounts[y] - sortCounts[x];
+    return x - y;
+}
+
+// Print the `limit` best suggestions for userId (all of them if limit <= 0)
+void suggestConnections(const char *userId, int limit) {
+    int idx = findUserIndex(userId);
+    if (idx == -1) {
+        printf("User not found.\n");
+        return;
+    }
+    if (!scratchReserve()) {
+        printf("Not enough memory for suggestions.\n");
+        return;
+    }
+
+    int *counts = scratch.counts, *candidates = scratch.queue;
+    int candidateCount = countSuggestions(idx, counts, candidates);
+    sortCounts = counts;
+    qsort(candidates, candidateCount, sizeof(int), compareSuggestions);
+    int shown = limit > 0 && candidateCount > limit ? limit : candidateCount;
+
+    printf("--- Suggested Connections for %s ---\n", userId);
+    for (int i = 0; i < shown; ++i) {
+        printf("%s (%d mutual connection(s))\n", users[candidates[i]].username, counts[candidates[i]]);
+    }
+    for (int i = 0; i < candidateCount; ++i) counts[candidates[i]] = 0;
+    if (candidateCount == 0) printf("No suggestions available.\n");
+    printf("--------------------------------\n");
+}
+
+// BFS from startIdx; fills path[] (room for userCount entries) from start to
+// end and returns its length (0 if unreachable)
+int shortestPathIndices(int startIdx, int endIdx, int *path) {
+    if (startIdx == endIdx) {
+        path[0] = startIdx;
+        return 1;
+    }
+    if (!scratchReserve()) return 0;
+
+    int epoch = scratchNextEpoch();
+    int *mark = scratch.mark, *parent = scratch.parent, *queue = scratch.queue;
+    int front = 0, rear = 0;
+    queue[rear++] = startIdx;
+    mark[startIdx] = epoch;
+
+    while (front < rear && mark[endIdx] != epoch) {
+        int curr = queue[front++];
+        for (int i = 0; i < users[curr].connectionCount; ++i) {
+            int neighborIdx = users[curr].connections[i];
+            if (mark[neighborIdx] != epoch) {
+                mark[neighborIdx] = epoch;
+                parent[neighborIdx] = curr;
+                queue[rear++] = neighborIdx;
+            }
+        }
+    }
+
+    if (mark[endIdx] != epoch) return 0;
+
+    // Trace path backwards, then reverse it
+    int length = 0;
+    for (int at = endIdx; at != startIdx; at = parent[at])
+        path[length++] = at;
+    path[length++] = startIdx;
+    for (int i = 0; i < length / 2; ++i) {
+        int tmp = path[i];
+        path[i] = path[length - 1 - i];
+        path[length - 1 - i] = tmp;
+    }
+    return length;
+}
+
+void findShortestPath(const char *start, const char *end) {
+    int startIdx = findUserIndex(start);
+    int endIdx = findUserIndex(end);
+    if (startIdx == -1 || endIdx == -1) {
+        printf("One or both users not found.\n");
+        return;
+    }
+
+    int *path = malloc(userCount * sizeof(int));
+    int length = path == NULL ? 0 : shortestPathIndices(startIdx, endIdx, path);
+    if (length == 0) {
+        printf("No path found between %s and %s.\n", start, end);
+        free(path);
+        return;
+    }
+
+    printf("--- Shortest Path from %s to %s ---\n", start, end);
+    for (int i = 0; i < length; ++i) {
+        printf("%s", users[path[i]].username);
+        if (i != length - 1) printf(" -> ");
+    }
+    printf("\n--------------------------------\n");
+    free(path);
+}
+// Value of the named attribute ("department", "interest" or "aim"), or NULL
+const char *userAttribute(int idx, const char *filterType) {
+    if (strcmp(filterType, "department") == 0) return users[idx].department;
+    if (strcmp(filterType, "interest") == 0) return users[idx].interest;
+    if (strcmp(filterType, "aim") == 0) return users[idx].aim;
+    return NULL;
+}
+
+void showMutualFriendsByFilter(const char *user1, const char *user2, const char *filterType) {
+    int idx1 = findUserIndex(user1);
+    int idx2 = findUserIndex(user2);
+
+    if (idx1 == -1 || idx2 == -1) {
+        printf("One or both users not found.\n");
+        return;
+    }
+
+    printf("--- Mutual Friends Between %s and %s (Filtered by %s) ---\n", user1, user2, filterType);
+    bool found = false;
+    const char *wanted = userAttribute(idx1, filterType);
+
+    // Walk the shorter connection list and probe the other user's edges
+    int small = users[idx1].connectionCount <= users[idx2].connectionCount ? idx1 : idx2;
+    int other = small == idx1 ? idx2 : idx1;
+    for (int i = 0; wanted != NULL && i < users[small].connectionCount; ++i) {
+        int mutualIdx = users[small].connections[i];
+        if (hasEdge(other, mutualIdx) && strcmp(userAttribute(mutualIdx, filterType), wanted) == 0) {
+            printf("%s (%s, %s)\n", users[mutualIdx].username, users[mutualIdx].role, wanted);
+            found = true;
+        }
+    }
+
+    if (!found)
+        printf("No mutual friends match the given filter.\n");
+
+    printf("--------------------------------\n");
+}
+
+
+// ---------------- Adjacency matrix ----------------
+// One bit per user pair, rows padded to whole 64-bit words
+typedef struct {
+    int n;
+    int wordsPerRow;
+    unsigned long long *bits;
+} BitMatrix;
+
+// Build the matrix in one pass over the edge set; bits is NULL if out of memory
+BitMatrix buildBitMatrix(void) {
+    BitMatrix m;
+    m.n = userCount;
+    m.wordsPerRow = (userCount + 63) / 64;
+    m.bits = calloc((size_t)m.n * m.wordsPerRow + 1, sizeof(unsigned long long));
+    if (m.bits == NULL) return m;
+    for (int s = 0; s < edgeSet.capacity; ++s) {
+        if (edgeSet.keys[s] == 0) continue;
+        unsigned long long key = edgeSet.keys[s] - 1;
+        int lo = (int)(key >> 32), hi = (int)(key & 0xFFFFFFFFULL);
+        m.bits[(size_t)lo * m.wordsPerRow + hi / 64] |= 1ULL << (hi % 64);
+        m.bits[(size_t)hi * m.wordsPerRow + lo / 64] |= 1ULL << (lo % 64);
+    }
+    return m;
+}
+
+void freeBitMatrix(BitMatrix *m) {
+    free(m->bits);
+    m->bits = NULL;
+}
+
+static inline int bitMatrixGet(const BitMatrix *m, int row, int col) {
+    return (m->bits[(size_t)row * m->wordsPerRow + col / 64] >> (col % 64)) & 1;
+}
+
+static int bitMatrixRowCount(const BitMatrix *m, int row) {
+    int count = 0;
+    for (int w = 0; w < m->wordsPerRow; ++w) count += __builtin_popcountll(m->bits[(size_t)row * m->wordsPerRow + w]);
+    return count;
+}
+
+// Dense rows [firstRow, lastRow): a header line of usernames, then
+// "name 0 1 0 ..." per row. Each row is formatted into one reused buffer;
+// false if that buffer cannot be allocated.
+bool writeDenseRows(FILE *out, const BitMatrix *m, int firstRow, int lastRow) {
+    char *line = malloc((size_t)m->n * 2 + 1);
+    if (line == NULL) return false;
+    fprintf(out, "user");
+    for (int j = 0; j < m->n; ++j) fprintf(out, " %s", users[j].username);
+    fputc('\n', out);
+
+    for (int i = firstRow; i < lastRow; ++i) {
+        for (int j = 0; j < m->n; ++j) {
+            line[2 * j] = ' ';
+            line[2 * j + 1] = (char)('0' + bitMatrixGet(m, i, j));
+        }
+        line[2 * m->n] = '\n';
+        fputs(users[i].username, out);
+        fwrite(line, 1, (size_t)m->n * 2 + 1, out);
+    }
+    free(line);
+    return true;
+}
+
+// Compressed sparse rows: "n nnz", the n + 1 row offsets, then the column
+// index of every set bit, one row per line
+void writeCsr(FILE *out, const BitMatrix *m) {
+    long long nnz = 0;
+    for (int i = 0; i < m->n; ++i) nnz += bitMatrixRowCount(m, i);
+    fprintf(out, "%d %lld\n0", m->n, nnz);
+    long long offset = 0;
+    for (int i = 0; i < m->n; ++i) {
+        offset += bitMatrixRowCount(m, i);
+        fprintf(out, " %lld", offset);
+    }
+    fputc('\n', out);
+    for (int i = 0; i < m->n; ++i) {
+        const unsigned long long *row = m->bits + (size_t)i * m->wordsPerRow;
+        bool first = true;
+        for (int w = 0; w < m->wordsPerRow; ++w) {
+            for (unsigned long long bits = row[w]; bits != 0; bits &= bits - 1) {
+                fprintf(out, first ? "%d" : " %d", w * 64 + __builtin_ctzll(bits));
+                first = false;
+            }
+        }
+        fputc('\n', out);
+    }
+}
+
+// Matrix Market coordinate format (symmetric pattern, lower triangle, 1-based)
+void writeMatrixMarket(FILE *out, const BitMatrix *m) {
+    long long nnz = 0;
+    for (int i = 0; i < m->n; ++i) nnz += bitMatrixRowCount(m, i);
+    fprintf(out, "%%%%MatrixMarket matrix coordinate pattern symmetric\n");
+    fprintf(out, "%% users listed in registration order\n");
+    fprintf(out, "%d %d %lld\n", m->n, m->n, nnz / 2);
+    for (int i = 0; i < m->n; ++i) {
+        const unsigned long long *row = m->bits + (size_t)i * m->wordsPerRow;
+        for (int w = 0; w <= i / 64; ++w) {
+            for (unsigned long long bits = row[w]; bits != 0; bits &= bits - 1) {
+                int j = w * 64 + __builtin_ctzll(bits);
+                if (j < i) fprintf(out, "%d %d\n", i + 1, j + 1);
+            }
+        }
+    }
+}
+
+// Write the matrix to `filename` as "dense", "rows" (dense rows
+// [firstRow, lastRow)), "csr" or "mtx"; false on a bad format or IO error
+bool exportAdjacencyMatrix(const char *format, const char *filename, int firstRow, int lastRow) {
+    if (strcmp(format, "dense") == 0) {
+        firstRow = 0;
+        lastRow = userCount;
+    } else if (strcmp(format, "rows") == 0) {
+        if (firstRow < 0) firstRow = 0;
+        if (lastRow > userCount) lastRow = userCount;
+        if (firstRow > lastRow) return false;
+    } else if (strcmp(format, "csr") != 0 && strcmp(format, "mtx") != 0) {
+        return false;
+    }
+
+    BitMatrix m = buildBitMatrix();
+    if (m.bits == NULL) return false;
+    FILE *out = fopen(filename, "w");
+    if (out == NULL) {
+        freeBitMatrix(&m);
+        return false;
+    }
+    setvbuf(out, NULL, _IOFBF, 1 << 20);
+    bool written = true;
+    if (strcmp(format, "csr") == 0) {
+        writeCsr(out, &m);
+    } else if (strcmp(format, "mtx") == 0) {
+        writeMatrixMarket(out, &m);
+    } else {
+        written = writeDenseRows(out, &m, firstRow, lastRow);
+    }
+    bool ok = written && !ferror(out);
+    ok = fclose(out) == 0 && ok;
+    freeBitMatrix(&m);
+    return ok;
+}
+
+void showAdjacencyMatrix() {
+    BitMatrix m = buildBitMatrix();
+    if (m.bits == NULL) {
+        printf("Not enough memory for the adjacency matrix.\n");
+        return;
+    }
+    printf("--- Adjacency Matrix ---\n     ");
+    for (int i = 0; i < userCount; ++i)
+        printf("%-10s", users[i].username);
+    printf("\n");
+
+    for (int i = 0; i < userCount; ++i) {
+        printf("%-5s", users[i].username);
+        for (int j = 0; j < userCount; ++j) {
+            printf("%-10d", bitMatrixGet(&m, i, j));
+        }
+        printf("\n");
+    }
+    printf("--------------------------------\n");
+    freeBitMatrix(&m);
+}
+
+#include <sys/stat.h> // for mkdir on Unix systems
+#include <pthread.h>
+#include <unistd.h>
+
+// One department file to write: its posting list from departmentIndex
+typedef struct {
+    Posting *members;
+    char filename[256];
+    bool ok;
+} DepartmentExport;
+
+typedef struct {
+    DepartmentExport *jobs;
+    int *order; // job indices, largest department first
+    int count;
+    int next;   // next position in order, claimed atomically
+} DepartmentExportQueue;
+
+// Write one department's DOT subgraph. Departments are interned, so
+// membership is a pointer comparison.
+static bool writeDepartmentGraph(DepartmentExport *job) {
+    FILE *dotFile = fopen(job->filename, "w");
+    if (!dotFile) return false;
+    setvbuf(dotFile, NULL, _IOFBF, 1 << 20);
+
+    const Posting *members = job->members;
+    const char *dept = members->value;
+    fprintf(dotFile, "graph \"%s_Network\" {\n", dept);
+    fprintf(dotFile, "  node [shape=ellipse, style=filled, fillcolor=lightyellow];\n");
+
+    // Add department nodes
+    for (int m = 0; m < members->count; ++m) {
+        const User *u = &users[members->userIdx[m]];
+        fprintf(dotFile, "  \"%s\" [label=\"%s\\n%s\\n%s\\n%s\"];\n",
+                u->username, u->username, u->role, u->interest, u->game);
+    }
+
+    // Add department connections
+    for (int m = 0; m < members->count; ++m) {
+        const User *u = &users[members->userIdx[m]];
+        for (int k = 0; k < u->connectionCount; ++k) {
+            const User *conn = &users[u->connections[k]];
+            if (conn->department != dept) continue;
+            if (strcmp(u->username, conn->username) < 0) {
+                fprintf(dotFile, "  \"%s\" -- \"%s\";\n", u->username, conn->username);
+            }
+        }
+    }
+
+    fprintf(dotFile, "}\n");
+    bool ok = !ferror(dotFile);
+    return fclose(dotFile) == 0 && ok;
+}
+
+static void *departmentExportWorker(void *arg) {
+    DepartmentExportQueue *queue = arg;
+    int i;
+    while ((i = __atomic_fetch_add(&queue->next, 1, __ATOMIC_RELAXED)) < queue->count) {
+        DepartmentExport *job = &queue->jobs[queue->order[i]];
+        job->ok = writeDepartmentGraph(job);
+    }
+    return NULL;
+}
+
+static const DepartmentExport *sortJobs; // qsort has no context argument
+
+// Departments in order of their first member, so the report follows registration order
+static int compareFirstMember(const void *a, const void *b) {
+    const DepartmentExport *x = a, *y = b;
+    return x->members->userIdx[0] - y->members->userIdx[0];
+}
+
+// Larger departments first, so no thread is left with a big one at the end
+static int compareMemberCount(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return sortJobs[y].members->count - sortJobs[x].members->count;
+}
+
+// Export Graphs by Department: one DOT file per department, each written
+// once from its posting list, departments spread over all cores
+void exportGraphsByDepartment(const char *outputDir) {
+#ifdef _WIN32
+    mkdir(outputDir);
+#else
+    mkdir(outputDir, 0755);
+#endif
+
+    DepartmentExportQueue queue = {NULL, NULL, 0, 0};
+    queue.jobs = malloc((departmentIndex.size + 1) * sizeof(DepartmentExport));
+    queue.order = malloc((departmentIndex.size + 1) * sizeof(int));
+    if (queue.jobs == NULL || queue.order == NULL) {
+        printf("Not enough memory to export the department graphs.\n");
+        free(queue.jobs);
+        free(queue.order);
+        return;
+    }
+    for (int s = 0; s < departmentIndex.capacity; ++s) {
+        Posting *posting = &departmentIndex.slots[s];
+        if (posting->userIdx == NULL || posting->count == 0) continue;
+        DepartmentExport *job = &queue.jobs[queue.count++];
+        job->members = posting;
+        job->ok = false;
+        snprintf(job->filename, sizeof(job->filename), "%s/%s_graph.dot", outputDir, posting->value);
+    }
+    qsort(queue.jobs, queue.count, sizeof(DepartmentExport), compareFirstMember);
+    for (int i = 0; i < queue.count; ++i) queue.order[i] = i;
+    sortJobs = queue.jobs;
+    qsort(queue.order, queue.count, sizeof(int), compareMemberCount);
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int threadCount = cores < 1 ? 1 : cores > 64 ? 64 : (int)cores;
+    if (threadCount > queue.count) threadCount = queue.count;
+    pthread_t threads[64];
+    int started = 0;
+    while (started + 1 < threadCount &&
+           pthread_create(&threads[started], NULL, departmentExportWorker, &queue) == 0) {
+        started++;
+    }
+    departmentExportWorker(&queue); // this thread works too
+    for (int t = 0; t < started; ++t) pthread_join(threads[t], NULL);
+
+    for (int i = 0; i < queue.count; ++i) {
+        if (queue.jobs[i].ok) {
+            printf("Exported: %s\n", queue.jobs[i].filename);
+        } else {
+            printf("Could not open file: %s\n", queue.jobs[i].filename);
+        }
+    }
+    free(queue.jobs);
+    free(queue.order);
+}
+
+void exportMutualHighlightGraph(const char *user1, const char *user2, const char *filename) {
+    int idx1 = findUserIndex(user1);
+    int idx2 = findUserIndex(user2);
+
+    if (idx1 == -1 || idx2 == -1) {
+        printf("One or both users not found.\n");
+        return;
+    }
+
+    FILE *dotFile = fopen(filename, "w");
+    if (!dotFile) {
+        printf("Unable to create DOT file.\n");
+        return;
+    }
+
+    fprintf(dotFile, "graph MutualHighlight {\n");
+
+    fprintf(dotFile, "  node [shape=ellipse, style=filled, fillcolor=white];\n");
+
+    // Declare all users
+    for (int i = 0; i < userCount; ++i) {
+        fprintf(dotFile, "  \"%s\";\n", users[i].username);
+    }
+
+    // Highlight mutual friends
+    for (int i = 0; i < users[idx1].connectionCount; ++i) {
+        const char *conn = users[users[idx1].connections[i]].username;
+        if (hasEdge(idx2, users[idx1].connections[i])) {
+            fprintf(dotFile, "  \"%s\" [fillcolor=lightgreen];\n", conn);
+
+            fprintf(dotFile, "  \"%s\" -- \"%s\" [color=green, penwidth=2.0];\n", user1, conn);
+
+            fprintf(dotFile, "  \"%s\" -- \"%s\" [color=green, penwidth=2.0];\n", user2, conn);
+        }
+    }
+
+    // Draw all other connections
+    for (int i = 0; i < userCount; ++i) {
+        for (int j = 0; j < users[i].connectionCount; ++j) {
+            int connIdx = users[i].connections[j];
+            const char *u1 = users[i].username;
+            const char *u2 = users[connIdx].username;
+
+            // Avoid duplicate edges
+            if (strcmp(u1, u2) < 0) {
+                if (!(i == idx1 && hasEdge(idx2, connIdx))) {
+                    fprintf(dotFile, "  \"%s\" -- \"%s\";\n", u1, u2);
+                }
+            }
+        }
+    }
+
+    fprintf(dotFile, "}\n");
+    fclose(dotFile);
+    printf("Mutual highlight graph exported to %s\n", filename);
+}
+
+// ---------------- Headless rendering ----------------
+// A picture of the whole network without a display: PPM (P6) or SVG.
+// Departments are square blocks of users packed in rows, largest first, so
+// the layout needs no simulation; every user is a dot in its department's
+// colour and every connection a line.
+//
+// Rasters are drawn in square tiles. Connections are binned into the tiles
+// their segment crosses (per tile column, the rows between its ends there),
+// dots into the tiles they touch, and worker threads then claim tiles until
+// none are left. A tile only writes its own pixels. Lines step along their
+// major axis with the minor coordinate taken from the line equation in
+// 32.32 fixed point, so a line drawn in pieces by several tiles has no seams.
+
+#define IMAGE_TILE 256
+#define IMAGE_MARGIN 16
+#define IMAGE_MAX_WIDTH 16384
+#define IMAGE_EDGE_SHADE 0x30
+
+typedef struct {
+    float x, y;
+} ImagePoint;
+
+typedef struct {
+    int width, height;
+    int tilesX, tilesY;
+    float radius;                // dot radius in pixels
+    ImagePoint *points;          // user index -> pixel position
+    int *colorOf;                // user index -> department number
+    unsigned char (*palette)[3]; // department number -> colour
+    int (*edges)[2];             // each connection once, lower index first
+    int edgeCount;
+    int *edgeStart, *tileEdges;  // tile -> connections crossing it
+    int *dotStart, *tileDots;    // tile -> users whose dot touches it
+    unsigned char edgeBlend[256]; // channel value -> value with one connection drawn over it
+    unsigned char *pixels;       // RGB rows, top to bottom
+    int nextTile;                // next tile to render, claimed atomically
+} NetworkImage;
+
+static const Posting **sortDepartments; // qsort has no context argument
+
+// Larger departments first, then registration order
+static int compareDepartmentSize(const void *a, const void *b) {
+    const Posting *x = sortDepartments[*(const int *)a], *y = sortDepartments[*(const int *)b];
+    if (x->count != y->count) return y->count - x->count;
+    return x->userIdx[0] - y->userIdx[0];
+}
+
+static int floorToInt(float value) {
+    int i = (int)value;
+    return i - (value < i);
+}
+
+static float clampFloat(float value, float low, float high) {
+    return value < low ? low : value > high ? high : value;
+}
+
+// Well separated colours: hues stepped by the golden ratio
+static void departmentColor(int number, unsigned char rgb[3]) {
+    float hue = number * 0.618034f + 0.12f;
+    hue = (hue - (int)hue) * 6;
+    int sector = (int)hue;
+    float f = hue - sector, value = 0.88f, saturation = 0.7f;
+    float p = value * (1 - saturation), q = value * (1 - saturation * f), t = value * (1 - saturation * (1 - f));
+    float table[6][3] = {{value, t, p}, {q, value, p}, {p, value, t}, {p, q, value}, {t, p, value}, {value, p, q}};
+    for (int c = 0; c < 3; ++c) rgb[c] = (unsigned char)(table[sector % 6][c] * 255);
+}
+
+static void freeNetworkImage(NetworkImage *image) {
+    free(image->points);
+    free(image->colorOf);
+    free(image->palette);
+    free(image->edges);
+    free(image->edgeStart);
+    free(image->tileEdges);
+    free(image->dotStart);
+    free(image->tileDots);
+    free(image->pixels);
+}
+
+// Place every user and size the image `width` pixels wide
+static bool layoutNetworkImage(NetworkImage *image, int width) {
+    int departments = 0;
+    const Posting **postings = malloc((departmentIndex.size + 1) * sizeof(Posting *));
+    int *order = malloc((departmentIndex.size + 1) * sizeof(int));
+    int *side = malloc((departmentIndex.size + 1) * sizeof(int));
+    image->points = malloc((userCount + 1) * sizeof(ImagePoint));
+    image->colorOf = malloc((userCount + 1) * sizeof(int));
+    image->palette = malloc((departmentIndex.size + 1) * sizeof(*image->palette));
+    if (!postings || !order || !side || !image->points || !image->colorOf || !image->palette) {
+        free(postings);
+        free(order);
+        free(side);
+        return false;
+    }
+    for (int s = 0; s < departmentIndex.capacity; ++s) {
+        Posting *posting = &departmentIndex.slots[s];
+        if (posting->userIdx == NULL || posting->count == 0) continue;
+        order[departments] = departments;
+        postings[departments++] = posting;
+    }
+    sortDepartments = postings;
+    qsort(order, departments, sizeof(int), compareDepartmentSize);
+
+    // Shelf packing in grid units (one per user, a gap of two between
+    // blocks) into rows a little wider than the picture will be tall
+    long long area = 0;
+    for (int d = 0; d < departments; ++d) {
+        int count = postings[order[d]]->count, s = 1;
+        while (s * s < count) s++;
+        side[d] = s;
+        area += (long long)(s + 2) * (s + 2);
+    }
+    int rowWidth = departments > 0 ? side[0] + 2 : 1;
+    while ((long long)rowWidth * rowWidth * 2 < area * 3) rowWidth++;
+    int blockX = 0, blockY = 0, rowHeight = 0, usedWidth = 1;
+    float scale = 1;
+    for (int pass = 0; pass < 2; ++pass) {
+        // The first pass measures, the second places users
+        blockX = blockY = rowHeight = 0;
+        for (int d = 0; d < departments; ++d) {
+            if (blockX > 0 && blockX + side[d] + 2 > rowWidth) {
+                blockY += rowHeight;
+                blockX = rowHeight = 0;
+            }
+            const Posting *posting = postings[order[d]];
+            for (int m = 0; pass == 1 && m < posting->count; ++m) {
+                int idx = posting->userIdx[m];
+                image->points[idx].x = IMAGE_MARGIN + (blockX + 1 + m % side[d] + 0.5f) * scale;
+                image->points[idx].y = IMAGE_MARGIN + (blockY + 1 + m / side[d] + 0.5f) * scale;
+                image->colorOf[idx] = d;
+            }
+            departmentColor(d, image->palette[d]);
+            blockX += side[d] + 2;
+            if (blockX > usedWidth) usedWidth = blockX;
+            if (side[d] + 2 > rowHeight) rowHeight = side[d] + 2;
+        }
+        image->width = width < 2 * IMAGE_MARGIN + 1 ? 2 * IMAGE_MARGIN + 1
+                       : width > IMAGE_MAX_WIDTH     ? IMAGE_MAX_WIDTH
+                                                     : width;
+        scale = (float)(image->width - 2 * IMAGE_MARGIN) / usedWidth;
+        image->height = (int)((blockY + rowHeight) * scale) + 2 * IMAGE_MARGIN + 1;
+    }
+    image->radius = clampFloat(scale * 0.35f, 0.5f, 6.0f);
+    free(postings);
+    free(order);
+    free(side);
+    return true;
+}
+
+// Bin connections (list NULL: count them per tile in start[tile + 1])
+static void binImageEdges(NetworkImage *image, int *start, int *list) {
+    float tile = IMAGE_TILE;
+    for (int e = 0; e < image->edgeCount; ++e) {
+        ImagePoint a = image->points[image->edges[e][0]], b = image->points[image->edges[e][1]];
+        if (a.x > b.x) {
+            ImagePoint swap = a;
+            a = b;
+            b = swap;
+        }
+        // Everything widened by a pixel for the rounding in drawImageLine
+        int firstColumn = (int)clampFloat((a.x - 1) / tile, 0, image->tilesX - 1);
+        int lastColumn = (int)clampFloat((b.x + 1) / tile, 0, image->tilesX - 1);
+        float slope = b.x > a.x ? (b.y - a.y) / (b.x - a.x) : 0;
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            float left = a.x > column * tile - 1 ? a.x : column * tile - 1;
+            float right = b.x < (column + 1) * tile + 1 ? b.x : (column + 1) * tile + 1;
+            float yLeft = b.x > a.x ? a.y + (left - a.x) * slope : a.y;
+            float yRight = b.x > a.x ? a.y + (right - a.x) * slope : b.y;
+            float top = yLeft < yRight ? yLeft : yRight, bottom = yLeft < yRight ? yRight : yLeft;
+            int firstRow = (int)clampFloat((top - 1) / tile, 0, image->tilesY - 1);
+            int lastRow = (int)clampFloat((bottom + 1) / tile, 0, image->tilesY - 1);
+            for (int row = firstRow; row <= lastRow; ++row) {
+                int t = row * image->tilesX + column;
+                if (list == NULL) start[t + 1]++;
+                else list[start[t]++] = e;
+            }
+        }
+    }
+}
+
+static void binImageDots(NetworkImage *image, int *start, int *list) {
+    float tile = IMAGE_TILE, reach = image->radius + 1;
+    for (int i = 0; i < userCount; ++i) {
+        ImagePoint p = image->points[i];
+        int firstColumn = (int)clampFloat((p.x - reach) / tile, 0, image->tilesX - 1);
+        int lastColumn = (int)clampFloat((p.x + reach) / tile, 0, image->tilesX - 1);
+        int firstRow = (int)clampFloat((p.y - reach) / tile, 0, image->tilesY - 1);
+        int lastRow = (int)clampFloat((p.y + reach) / tile, 0, image->tilesY - 1);
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (int column = firstColumn; column <= lastColumn; ++column) {
+                int t = row * image->tilesX + column;
+                if (list == NULL) start[t + 1]++;
+                else list[start[t]++] = i;
+            }
+        }
+    }
+}
+
+// Count, prefix-sum, fill: a CSR list of items per tile
+static int *binImageTiles(NetworkImage *image, void (*bin)(NetworkImage *, int *, int *), int **start) {
+    int tiles = image->tilesX * image->tilesY;
+    *start = calloc(tiles + 1, sizeof(int));
+    int *cursor = malloc((tiles + 1) * sizeof(int));
+    if (*start == NULL || cursor == NULL) {
+        free(cursor);
+        return NULL;
+    }
+    bin(image, *start, NULL);
+    for (int t = 0; t < tiles; ++t) (*start)[t + 1] += (*start)[t];
+    int *list = malloc(((*start)[tiles] + 1) * sizeof(int));
+    if (list != NULL) {
+        memcpy(cursor, *start, tiles * sizeof(int));
+        bin(image, cursor, list);
+    }
+    free(cursor);
+    return list;
+}
+
+// Draw the part of segment a-b inside the tile [x0, x1) x [y0, y1)
+static void drawImageLine(NetworkImage *image, ImagePoint a, ImagePoint b, int x0, int y0, int x1, int y1) {
+    float dx = b.x - a.x, dy = b.y - a.y;
+    bool steep = (dy < 0 ? -dy : dy) > (dx < 0 ? -dx : dx);
+    if (steep) {
+        float swap = a.x; a.x = a.y; a.y = swap;
+        swap = b.x; b.x = b.y; b.y = swap;
+        int t = x0; x0 = y0; y0 = t;
+        t = x1; x1 = y1; y1 = t;
+    }
+    if (a.x > b.x) {
+        ImagePoint swap = a;
+        a = b;
+        b = swap;
+    }
+    float slope = b.x > a.x ? (b.y - a.y) / (b.x - a.x) : 0;
+    float first = clampFloat(a.x + 0.5f, x0, x1), last = clampFloat(b.x + 0.5f, x0 - 1, x1 - 1);
+    if (slope != 0) {
+        // Major coordinates where the minor one rounds into [y0, y1)
+        float enter = a.x + (y0 - 0.5f - a.y) / slope, leave = a.x + (y1 - 0.5f - a.y) / slope;
+        if (enter > leave) {
+            float swap = enter;
+            enter = leave;
+            leave = swap;
+        }
+        if (enter - 1 > first) first = clampFloat(enter - 1, x0, x1);
+        if (leave + 1 < last) last = clampFloat(leave + 1, x0 - 1, x1 - 1);
+    }
+    const double one = 4294967296.0;
+    long long step = (long long)((double)slope * one);
+    long long base = (long long)(((double)a.y + 0.5 - (double)a.x * slope) * one);
+    size_t majorStride = steep ? (size_t)image->width * 3 : 3, minorStride = steep ? 3 : (size_t)image->width * 3;
+    for (int major = floorToInt(first); major <= floorToInt(last); ++major) {
+        int minor = (int)((base + major * step) >> 32);
+        if (minor < y0 || minor >= y1) continue;
+        unsigned char *pixel = &image->pixels[major * majorStride + minor * minorStride];
+        pixel[0] = image->edgeBlend[pixel[0]];
+        pixel[1] = image->edgeBlend[pixel[1]];
+        pixel[2] = image->edgeBlend[pixel[2]];
+    }
+}
+
+static void drawImageDot(NetworkImage *image, int idx, int x0, int y0, int x1, int y1) {
+    ImagePoint p = image->points[idx];
+    const unsigned char *color = image->palette[image->colorOf[idx]];
+    float reach = image->radius;
+    int left = floorToInt(p.x - reach), right = floorToInt(p.x + reach) + 1;
+    int top = floorToInt(p.y - reach), bottom = floorToInt(p.y + reach) + 1;
+    for (int y = top > y0 ? top : y0; y <= bottom && y < y1; ++y) {
+        for (int x = left > x0 ? left : x0; x <= right && x < x1; ++x) {
+            float dx = x + 0.5f - p.x, dy = y + 0.5f - p.y;
+            if (dx * dx + dy * dy <= reach * reach || (x == floorToInt(p.x) && y == floorToInt(p.y))) {
+                memcpy(&image->pixels[((size_t)y * image->width + x) * 3], color, 3);
+            }
+        }
+    }
+}
+
+static void *renderImageWorker(void *arg) {
+    NetworkImage *image = arg;
+    int tiles = image->tilesX * image->tilesY, t;
+    while ((t = __atomic_fetch_add(&image->nextTile, 1, __ATOMIC_RELAXED)) < tiles) {
+        int x0 = t % image->tilesX * IMAGE_TILE, y0 = t / image->tilesX * IMAGE_TILE;
+        int x1 = x0 + IMAGE_TILE < image->width ? x0 + IMAGE_TILE : image->width;
+        int y1 = y0 + IMAGE_TILE < image->height ? y0 + IMAGE_TILE : image->height;
+        for (int i = image->edgeStart[t]; i < image->edgeStart[t + 1]; ++i) {
+            const int *edge = image->edges[image->tileEdges[i]];
+            drawImageLine(image, image->points[edge[0]], image->points[edge[1]], x0, y0, x1, y1);
+        }
+        for (int i = image->dotStart[t]; i < image->dotStart[t + 1]; ++i) {
+            drawImageDot(image, image->tileDots[i], x0, y0, x1, y1);
+        }
+    }
+    return NULL;
+}
+
+// Rasterize the laid out image on all cores
+static bool rasterizeNetworkImage(NetworkImage *image) {
+    image->tilesX = (image->width + IMAGE_TILE - 1) / IMAGE_TILE;
+    image->tilesY = (image->height + IMAGE_TILE - 1) / IMAGE_TILE;
+    image->pixels = malloc((size_t)image->width * image->height * 3);
+    image->tileEdges = binImageTiles(image, binImageEdges, &image->edgeStart);
+    image->tileDots = binImageTiles(image, binImageDots, &image->dotStart);
+    if (!image->pixels || !image->tileEdges || !image->tileDots) return false;
+    memset(image->pixels, 255, (size_t)image->width * image->height * 3);
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int tiles = image->tilesX * image->tilesY;
+    int threadCount = cores < 1 ? 1 : cores > 64 ? 64 : (int)cores;
+    if (threadCount > tiles) threadCount = tiles;
+    pthread_t threads[64];
+    int started = 0;
+    image->nextTile = 0;
+    while (started + 1 < threadCount &&
+           pthread_create(&threads[started], NULL, renderImageWorker, image) == 0) {
+        started++;
+    }
+    renderImageWorker(image); // this thread works too
+    for (int t = 0; t < started; ++t) pthread_join(threads[t], NULL);
+    return true;
+}
+
+static bool writeImagePPM(const NetworkImage *image, const char *filename) {
+    FILE *file = fopen(filename, "wb");
+    if (!file) return false;
+    fprintf(file, "P6\n%d %d\n255\n", image->width, image->height);
+    fwrite(image->pixels, 3, (size_t)image->width * image->height, file);
+    bool ok = !ferror(file);
+    return fclose(file) == 0 && ok;
+}
+
+// Connections as paths of a few thousand segments, users grouped by
+// department under one fill colour
+static bool writeImageSVG(const NetworkImage *image, const char *filename, unsigned edgeAlpha) {
+    FILE *file = fopen(filename, "w");
+    if (!file) return false;
+    setvbuf(file, NULL, _IOFBF, 1 << 20);
+    fprintf(file, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" viewBox=\"0 0 %d %d\">\n",
+            image->width, image->height, image->width, image->height);
+    fprintf(file, "<rect width=\"100%%\" height=\"100%%\" fill=\"#ffffff\"/>\n");
+    for (int e = 0; e < image->edgeCount; ++e) {
+        if (e % 4096 == 0) {
+            fprintf(file, "%s<path fill=\"none\" stroke=\"#303030\" stroke-width=\"0.6\" stroke-opacity=\"%.3f\" d=\"",
+                    e > 0 ? "\"/>\n" : "", edgeAlpha / 255.0);
+        }
+        ImagePoint a = image->points[image->edges[e][0]], b = image->points[image->edges[e][1]];
+        fprintf(file, "M%.1f %.1fL%.1f %.1f", a.x, a.y, b.x, b.y);
+    }
+    if (image->edgeCount > 0) fprintf(file, "\"/>\n");
+
+    for (int s = 0; s < departmentIndex.capacity; ++s) {
+        const Posting *posting = &departmentIndex.slots[s];
+        if (posting->userIdx == NULL || posting->count == 0) continue;
+        const unsigned char *color = image->palette[image->colorOf[posting->userIdx[0]]];
+        fprintf(file, "<g fill=\"#%02x%02x%02x\">\n", color[0], color[1], color[2]);
+        for (int m = 0; m < posting->count; ++m) {
+            ImagePoint p = image->points[posting->userIdx[m]];
+            fprintf(file, "<circle cx=\"%.1f\" cy=\"%.1f\" r=\"%.1f\"/>\n", p.x, p.y, image->radius);
+        }
+        fprintf(file, "</g>\n");
+    }
+    fprintf(file, "</svg>\n");
+    bool ok = !ferror(file);
+    return fclose(file) == 0 && ok;
+}
+
+// Render the network to `filename`: SVG if it ends in ".svg", PPM otherwise
+bool renderNetworkImage(const char *filename, int width) {
+    NetworkImage image;
+    memset(&image, 0, sizeof(image));
+    if (!layoutNetworkImage(&image, width)) {
+        freeNetworkImage(&image);
+        return false;
+    }
+
+    long long connections = 0;
+    for (int i = 0; i < userCount; ++i) connections += users[i].connectionCount;
+    image.edges = malloc((connections / 2 + 1) * sizeof(*image.edges));
+    if (image.edges == NULL) {
+        freeNetworkImage(&image);
+        return false;
+    }
+    for (int i = 0; i < userCount; ++i) {
+        for (int k = 0; k < users[i].connectionCount; ++k) {
+            int other = users[i].connections[k];
+            if (i < other) {
+                image.edges[image.edgeCount][0] = i;
+                image.edges[image.edgeCount++][1] = other;
+            }
+        }
+    }
+    // Dense networks turn into a grey sheet at full opacity
+    unsigned edgeAlpha = image.edgeCount > 200000 ? 24
+                         : image.edgeCount > 20000 ? 64
+                         : image.edgeCount > 2000  ? 128
+                                                   : 200;
+    for (int value = 0; value < 256; ++value) {
+        image.edgeBlend[value] = (unsigned char)(value + (IMAGE_EDGE_SHADE - value) * (edgeAlpha / 255.0) + 0.5);
+    }
+
+    size_t length = strlen(filename);
+    bool ok = length >= 4 && strcmp(filename + length - 4, ".svg") == 0
+                  ? writeImageSVG(&image, filename, edgeAlpha)
+                  : rasterizeNetworkImage(&image) && writeImagePPM(&image, filename);
+    freeNetworkImage(&image);
+    return ok;
+}
+
+// ---------------- Batch mode ----------------
+// `--batch FILE` (or `-` for stdin) runs one command per line without the menu
+// and prints one tab-separated result line per command, e.g.
+//   path a b            -> path<TAB>a<TAB>b<TAB>hops<TAB>a,x,b   (hops -1 if unreachable)
+//   suggest a 10        -> suggest<TAB>a<TAB>count<TAB>x:3,y:1
+//   dept CSE            -> dept<TAB>CSE<TAB>count<TAB>u1,u2
+//   connect a b         -> connect<TAB>a<TAB>b<TAB>ok
+//   matrix csr FILE     -> matrix<TAB>csr<TAB>FILE<TAB>ok  (also dense, mtx, rows FIRST LAST FILE)
+//   render FILE 2048    -> render<TAB>FILE<TAB>ok  (.svg or PPM; the width is optional)
+// Failures print "error<TAB>command<TAB>message". Stdout is fully buffered.
+
+#define BATCH_MAX_ARGS 8
+
+static const char *mutationError(MutationStatus status) {
+    switch (status) {
+        case MUTATION_EXISTS: return "already exists";
+        case MUTATION_FULL: return "out of memory";
+        case MUTATION_SELF: return "self connection";
+        case MUTATION_UNKNOWN_USER: return "unknown user";
+        default: return "ok";
+    }
+}
+
+static void batchPosting(AttributeIndex *index, const char *command, const char *value) {
+    Posting *posting = indexLookup(index, value);
+    int count = posting == NULL ? 0 : posting->count;
+    printf("%s\t%s\t%d\t", command, value, count);
+    for (int i = 0; i < count; ++i) {
+        printf(i == 0 ? "%s" : ",%s", users[posting->userIdx[i]].username);
+    }
+    printf("\n");
+}
+
+// Run one tokenized command; returns true if it changed the network
+static bool runBatchCommand(char **args, int argc) {
+    const char *command = args[0];
+    if (strcmp(command, "register") == 0 && (argc == 4 || argc == 7)) {
+        MutationStatus status = insertUser(args[1], args[2], args[3], argc == 7 ? args[4] : "null",
+                                           argc == 7 ? args[5] : "null", argc == 7 ? args[6] : "null");
+        if (status != MUTATION_OK) {
+            printf("error\t%s\t%s\n", command, mutationError(status));
+            return false;
+        }
+        printf("register\t%s\tok\n", args[1]);
+        return true;
+    }
+    if (strcmp(command, "connect") == 0 && argc == 3) {
+        MutationStatus status = connectUsers(args[1], args[2]);
+        if (status != MUTATION_OK) {
+            printf("error\t%s\t%s\n", command, mutationError(status));
+            return false;
+        }
+        printf("connect\t%s\t%s\tok\n", args[1], args[2]);
+        return true;
+    }
+    if (strcmp(command, "path") == 0 && argc == 3) {
+        int startIdx = findUserIndex(args[1]);
+        int endIdx = findUserIndex(args[2]);
+        if (startIdx == -1 || endIdx == -1) {
+            printf("error\t%s\tunknown user\n", command);
+            return false;
+        }
+        int *path = malloc(userCount * sizeof(int));
+        int length = path == NULL ? 0 : shortestPathIndices(startIdx, endIdx, path);
+        printf("path\t%s\t%s\t%d\t", args[1], args[2], length - 1);
+        for (int i = 0; i < length; ++i) {
+            printf(i == 0 ? "%s" : ",%s", users[path[i]].username);
+        }
+        printf("\n");
+        free(path);
+        return false;
+    }
+    if (strcmp(command, "suggest") == 0 && (argc == 2 || argc == 3)) {
+        int idx = findUserIndex(args[1]);
+        char *end = NULL;
+        long limit = argc == 3 ? strtol(args[2], &end, 10) : 10;
+        if (idx == -1 || (argc == 3 && (*end != '\0' || limit < 0))) {
+            printf("error\t%s\t%s\n", command, idx == -1 ? "unknown user" : "bad count");
+            return false;
+        }
+        if (!scratchReserve()) {
+            printf("error\t%s\tout of memory\n", command);
+            return false;
+        }
+        int *counts = scratch.counts, *order = scratch.queue;
+        int candidateCount = countSuggestions(idx, counts, order);
+        sortCounts = counts;
+        qsort(order, candidateCount, sizeof(int), compareSuggestions);
+        int shown = limit > 0 && candidateCount > limit ? (int)limit : candidateCount;
+        printf("suggest\t%s\t%d\t", args[1], shown);
+        for (int i = 0; i < shown; ++i) {
+            printf(i == 0 ? "%s:%d" : ",%s:%d", users[order[i]].username, counts[order[i]]);
+        }
+        printf("\n");
+        for (int i = 0; i < candidateCount; ++i) counts[order[i]] = 0;
+        return false;
+    }
+    if (strcmp(command, "matrix") == 0 && (argc == 3 || argc == 5)) {
+        bool rows = argc == 5;
+        const char *file = args[argc - 1];
+        if (rows != (strcmp(args[1], "rows") == 0) ||
+            !exportAdjacencyMatrix(args[1], file, rows ? atoi(args[2]) : 0, rows ? atoi(args[3]) : 0)) {
+            printf("error\t%s\tunable to write %s\n", command, file);
+        } else {
+            printf("matrix\t%s\t%s\tok\n", args[1], file);
+        }
+        return false;
+    }
+    if (strcmp(command, "render") == 0 && (argc == 2 || argc == 3)) {
+        if (!renderNetworkImage(args[1], argc == 3 ? atoi(args[2]) : 2048)) {
+            printf("error\t%s\tunable to write %s\n", command, args[1]);
+        } else {
+            printf("render\t%s\tok\n", args[1]);
+        }
+        return false;
+    }
+    if (argc == 2 && strcmp(command, "dept") == 0) {
+        batchPosting(&departmentIndex, command, args[1]);
+    } else if (argc == 2 && strcmp(command, "aim") == 0) {
+        batchPosting(&aimIndex, command, args[1]);
+    } else if (argc == 2 && strcmp(command, "interest") == 0) {
+        batchPosting(&interestIndex, command, args[1]);
+    } else {
+        printf("error\t%s\tunknown command or wrong number of arguments\n", command);
+    }
+    return false;
+}
+
+// Execute every command in `path` ("-" for stdin); saves the data if anything changed
+int runBatch(const char *path) {
+    FILE *in = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (in == NULL) {
+        fprintf(stderr, "Unable to open batch file %s\n", path);
+        return 1;
+    }
+    setvbuf(stdout, NULL, _IOFBF, 1 << 20);
+
+    char line[1024];
+    char *args[BATCH_MAX_ARGS];
+    int commands = 0;
+    bool changed = false;
+    while (fgets(line, sizeof(line), in) != NULL) {
+        int argc = 0;
+        for (char *token = strtok(line, " \t\r\n"); token != NULL && argc < BATCH_MAX_ARGS;
+             token = strtok(NULL, " \t\r\n")) {
+            args[argc++] = token;
+        }
+        if (argc == 0 || args[0][0] == '#') continue;
+        changed |= runBatchCommand(args, argc);
+        commands++;
+    }
+    if (in != stdin) fclose(in);
+    fflush(stdout);
+
+    if (changed) saveUserData("network_data.txt");
+    fprintf(stderr, "Processed %d commands\n", commands);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    char user1[MAX_LEN], user2[MAX_LEN];
+    char department[MAX_LEN], role[MAX_LEN];
+    char interest[MAX_LEN], game[MAX_LEN], aim[MAX_LEN];
+    char filterType[MAX_LEN], filename[256];
+
+    int choice, limit;
+    loadUserData("network_data.txt");
+    if (argc == 3 && strcmp(argv[1], "--batch") == 0) {
+        return runBatch(argv[2]);
+    }
+
+    while (1) {
+        printf("\n===== Social Media Graph Analyzer =====\n");
+        printf("1. Register User\n");
+        printf("2. Add Connection\n");
+        printf("3. Display Network\n");
+        printf("4. List Users by Department\n");
+        printf("5. List Users by Aim\n");
+        printf("6. List Users by Interest\n");
+        printf("7. Show Mutual Friends by Filter\n");
+        printf("8. Suggest Connections\n");
+        printf("9. Find Shortest Path\n");
+        printf("10. Export Graphs by Department\n");
+        printf("11. Export Mutual Highlight Graph\n");
+        printf("12. Show Adjacency Matrix\n");
+        printf("13. Render Network Image (PPM/SVG)\n");
+        printf("14. Save Data\n");
+        printf("15. Exit\n");
+        printf("Enter your choice: ");
+
+        scanf("%d", &choice);
+        getchar();  // consume newline
+
+        switch (choice) {
+            case 1:
+                printf("Enter username: ");
+                scanf("%s", user1);
+
+                printf("Enter department: ");
+                scanf("%s", department);
+
+                printf("Enter role: ");
+                scanf("%s", role);
+
+                printf("Enter field of interest: (write null if you have no interest in anything) ");
+                scanf("%s", interest);
+
+                printf("Enter favorite game: ");
+                scanf("%s", game);
+
+                printf("Enter aim in life: ");
+                scanf("%s", aim);
+                registerUser(user1, department, role, interest, game, aim);
+                break;
+
+            case 2:
+                printf("Enter first username: ");
+                scanf("%s", user1);
+                printf("Enter second username: ");
+                scanf("%s", user2);
+                addConnection(user1, user2);
+                break;
+
+            case 3:
+                displayNetwork();
+                break;
+
+            case 4:
+                printf("Enter department: ");
+                scanf("%s", department);
+                listUsersByDepartment(department);
+                break;
+
+            case 5:
+                printf("Enter aim: ");
+                scanf("%s", aim);
+                listUsersByAim(aim);
+                break;
+
+            case 6:
+                printf("Enter interest: ");
+                scanf("%s", interest);
+                listUsersByInterest(interest);
+                break;
+
+                case 7:
+                printf("Enter first username: ");
+                scanf("%s", user1);
+                printf("Enter second username: ");
+                scanf("%s", user2);
+                printf("Enter filter type (department/interest/aim): ");
+                scanf("%s", filterType);
+                showMutualFriendsByFilter(user1, user2, filterType);
+                break;
+            
+
+            case 8:
+                printf("Enter username: ");
+                scanf("%s", user1);
+                printf("How many suggestions (0 for all): ");
+                if (scanf("%d", &limit) != 1) limit = 0;
+                suggestConnections(user1, limit);
+                break;
+
+            case 9:
+                printf("Enter start user: ");
+                scanf("%s", user1);
+                printf("Enter end user: ");
+                scanf("%s", user2);
+                findShortestPath(user1, user2);
+                break;
+
+            case 10:
+                exportGraphsByDepartment("output");
+                break;
+
+            case 11:
+                printf("Enter first username: ");
+                scanf("%s", user1);
+                printf("Enter second username: ");
+                scanf("%s", user2);
+                printf("Enter filename for output (.dot): ");
+                scanf("%s", filename);
+                exportMutualHighlightGraph(user1, user2, filename);
+                break;
+
+            case 12: {
+                printf("Output (screen/dense/rows/csr/mtx): ");
+                scanf("%s", filterType);
+                if (strcmp(filterType, "screen") == 0) {
+                    showAdjacencyMatrix();
+                    break;
+                }
+                int firstRow = 0, lastRow = 0;
+                if (strcmp(filterType, "rows") == 0) {
+                    printf("Enter first and last row (0-based, last excluded): ");
+                    scanf("%d %d", &firstRow, &lastRow);
+                }
+                printf("Enter filename for output: ");
+                scanf("%s", filename);
+                if (exportAdjacencyMatrix(filterType, filename, firstRow, lastRow))
+                    printf("Adjacency matrix written to %s.\n", filename);
+                else
+                    printf("Unable to write the adjacency matrix (check the format and file).\n");
+                break;
+            }
+
+            case 13: {
+                int width = 2048;
+                printf("Enter filename for output (.ppm or .svg): ");
+                scanf("%s", filename);
+                printf("Enter image width in pixels: ");
+                scanf("%d", &width);
+                if (renderNetworkImage(filename, width))
+                    printf("Network image written to %s.\n", filename);
+                else
+                    printf("Unable to write the network image.\n");
+                break;
+            }
+
+            case 14:
+                saveUserData("network_data.txt");
+                printf("Data saved.\n");
+                break;
+
+            case 15:
+                saveUserData("network_data.txt");
+                printf("Exiting...\n");
+                return 0;
+
+            default:
+                printf("Invalid choice. Please try again.\n");
+        }
+    }
+
+    return 0;
+}
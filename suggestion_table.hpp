@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "graph_core.hpp"
+#include "graph_suggest.hpp"
+#include "mapped_file.hpp"
+#include "thread_pool.hpp"
+
+// Precomputed connection suggestions for every user.
+//
+// Layout: SuggestionTableHeader, uint64 rowOffsets[userCount + 1], then the
+// Suggestion entries of every user back to back, best first. The file is
+// mapped and served in place, so a lookup is two loads and no computation.
+// `logSequence` ties the table to the network state it was computed from:
+// it is only served while no mutation has been logged since.
+constexpr char suggestionTableMagic[8] = {'S', 'N', 'E', 'T', 'S', 'U', 'G', 'G'};
+constexpr uint32_t suggestionTableVersion = 1;
+
+struct SuggestionTableHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t limit;       // suggestions kept per user; 0 means all of them
+    uint64_t userCount;
+    uint64_t logSequence; // write-ahead log sequence the table reflects
+};
+
+struct SuggestionTableStats {
+    size_t users = 0;
+    size_t entries = 0;
+    double seconds = 0;
+    unsigned threads = 0;
+
+    double usersPerSecond() const { return seconds > 0 ? users / seconds : 0; }
+};
+
+// Compute the top-`k` suggestions of every user on `pool` and write the table
+// to `path` atomically. Every worker ranks users with its own scratch
+// counters; chunks are small because hub users cost far more than leaves.
+inline bool buildSuggestionTable(const std::string &path, const GraphCore &graph, size_t k, uint64_t logSequence,
+                                 SuggestionTableStats *stats = nullptr, ThreadPool &pool = ThreadPool::shared()) {
+    auto started = std::chrono::steady_clock::now();
+    graph.compact(); // workers only read the graph
+    uint32_t n = graph.userCount();
+
+    std::vector<std::vector<Suggestion>> rows(n);
+    std::vector<SuggestScratch> scratch(pool.size());
+    pool.parallelFor(n, 64, [&](size_t begin, size_t end, unsigned worker) {
+        for (size_t user = begin; user < end; ++user) {
+            rows[user] = suggestTopK(graph, static_cast<uint32_t>(user), k, scratch[worker]);
+        }
+    });
+
+    std::vector<uint64_t> offsets(n + 1, 0);
+    for (uint32_t user = 0; user < n; ++user) {
+        offsets[user + 1] = offsets[user] + rows[user].size();
+    }
+
+    SuggestionTableHeader header{};
+    memcpy(header.magic, suggestionTableMagic, sizeof(header.magic));
+    header.version = suggestionTableVersion;
+    header.limit = static_cast<uint32_t>(k);
+    header.userCount = n;
+    header.logSequence = logSequence;
+
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    for (const std::vector<Suggestion> &row : rows) {
+        out.write(reinterpret_cast<const char *>(row.data()), row.size() * sizeof(Suggestion));
+    }
+    out.close();
+    if (!out || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    if (stats != nullptr) {
+        stats->users = n;
+        stats->entries = offsets[n];
+        stats->threads = pool.size();
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+    return true;
+}
+
+// Read-only view of a table file
+class SuggestionTable {
+public:
+    // Map `path`; false (and an empty table) if it is missing or malformed
+    bool open(const std::string &path) {
+        close();
+        auto mapped = std::make_unique<MappedFile>(path);
+        const char *base = mapped->data();
+        size_t length = mapped->size();
+        if (length < sizeof(SuggestionTableHeader)) {
+            return false;
+        }
+        const auto *h = reinterpret_cast<const SuggestionTableHeader *>(base);
+        if (memcmp(h->magic, suggestionTableMagic, sizeof(h->magic)) != 0 || h->version != suggestionTableVersion ||
+            (length - sizeof(SuggestionTableHeader)) / sizeof(uint64_t) <= h->userCount) {
+            return false;
+        }
+        const auto *rowOffsets = reinterpret_cast<const uint64_t *>(base + sizeof(SuggestionTableHeader));
+        uint64_t entriesAt = sizeof(SuggestionTableHeader) + (h->userCount + 1) * sizeof(uint64_t);
+        if ((length - entriesAt) / sizeof(Suggestion) < rowOffsets[h->userCount]) {
+            return false;
+        }
+        header = h;
+        offsets = rowOffsets;
+        entries = reinterpret_cast<const Suggestion *>(base + entriesAt);
+        file = std::move(mapped);
+        return true;
+    }
+
+    void close() {
+        file.reset();
+        header = nullptr;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+
+    // Whether the table can answer a request for `k` suggestions (0 = all)
+    // made against the network at `logSequence` with `userCount` users
+    bool covers(size_t k, uint64_t logSequence, uint32_t userCount) const {
+        return isOpen() && header->logSequence == logSequence && header->userCount == userCount &&
+               (header->limit == 0 || (k != 0 && k <= header->limit));
+    }
+
+    // Stored suggestions of `user`, best first, cut to `k` (0 = all stored)
+    std::vector<Suggestion> lookup(uint32_t user, size_t k) const {
+        const Suggestion *first = entries + offsets[user];
+        size_t count = offsets[user + 1] - offsets[user];
+        if (k != 0) {
+            count = std::min(count, k);
+        }
+        return std::vector<Suggestion>(first, first + count);
+    }
+
+private:
+    std::unique_ptr<MappedFile> file;
+    const SuggestionTableHeader *header = nullptr;
+    const uint64_t *offsets = nullptr;
+    const Suggestion *entries = nullptr;
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Fixed set of worker threads running data-parallel loops with work stealing.
+//
+// parallelFor() cuts [0, count) into chunks and deals each worker a
+// contiguous run of them. A worker takes chunks from the front of its own
+// queue (good locality) and, once that is empty, steals from the back of the
+// others, so a few expensive items (hub users) cannot leave the rest of the
+// pool idle. The calling thread takes part as worker 0. Loops must not be
+// nested; one parallelFor runs at a time per pool.
+class ThreadPool {
+public:
+    // body(begin, end, worker) processes items [begin, end); worker < size()
+    using RangeBody = std::function<void(size_t begin, size_t end, unsigned worker)>;
+
+    explicit ThreadPool(unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+        threads = std::max(1u, threads);
+        for (unsigned i = 0; i < threads; ++i) {
+            queues.push_back(std::make_unique<ChunkQueue>());
+        }
+        for (unsigned i = 1; i < threads; ++i) {
+            workers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(queues.size()); }
+
+    // Run `body` over [0, count) in chunks of `grain` items; returns when all are done
+    void parallelFor(size_t count, size_t grain, const RangeBody &body) {
+        if (count == 0) {
+            return;
+        }
+        grain = std::max<size_t>(grain, 1);
+        size_t chunks = (count + grain - 1) / grain;
+        if (size() == 1 || chunks == 1) {
+            body(0, count, 0);
+            return;
+        }
+
+        for (unsigned w = 0; w < size(); ++w) {
+            size_t first = chunks * w / size(), last = chunks * (w + 1) / size();
+            std::lock_guard<std::mutex> lock(queues[w]->mutex);
+            for (size_t c = first; c < last; ++c) {
+                queues[w]->chunks.emplace_back(c * grain, std::min(count, (c + 1) * grain));
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &body;
+            running = size() - 1;
+            ++generation;
+        }
+        wake.notify_all();
+        runChunks(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return running == 0; });
+        job = nullptr;
+    }
+
+    // Process-wide pool sized to the machine
+    static ThreadPool &shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+private:
+    struct ChunkQueue {
+        std::mutex mutex;
+        std::deque<std::pair<size_t, size_t>> chunks;
+    };
+
+    std::vector<std::unique_ptr<ChunkQueue>> queues; // one per worker, index 0 is the caller
+    std::vector<std::thread> workers;
+    std::mutex mutex; // guards job, generation, running, stopping
+    std::condition_variable wake, finished;
+    const RangeBody *job = nullptr;
+    uint64_t generation = 0;
+    unsigned running = 0;
+    bool stopping = false;
+
+    bool takeOwn(unsigned worker, std::pair<size_t, size_t> &chunk) {
+        ChunkQueue &queue = *queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.chunks.empty()) {
+            return false;
+        }
+        chunk = queue.chunks.front();
+        queue.chunks.pop_front();
+        return true;
+    }
+
+    bool steal(unsigned worker, std::pair<size_t, size_t> &chunk) {
+        for (unsigned i = 1; i < size(); ++i) {
+            ChunkQueue &victim = *queues[(worker + i) % size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.chunks.empty()) {
+                chunk = victim.chunks.back();
+                victim.chunks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Chunks are only ever removed during a loop, so once every queue is
+    // seen empty this worker is done
+    void runChunks(unsigned worker) {
+        std::pair<size_t, size_t> chunk;
+        while (takeOwn(worker, chunk) || steal(worker, chunk)) {
+            (*job)(chunk.first, chunk.second, worker);
+        }
+    }
+
+    void workerLoop(unsigned worker) {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            lock.unlock();
+            runChunks(worker);
+            lock.lock();
+            if (--running == 0) {
+                finished.notify_one();
+            }
+        }
+    }
+};
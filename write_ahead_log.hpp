@@ -0,0 +1,341 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "snapshot.hpp"
+
+// Kinds of mutation recorded in the log
+enum LogRecordType : uint8_t {
+    LogRegisterUser = 1,  // username, then one value per attribute
+    LogAddConnection = 2, // user1, user2
+    LogSetAttribute = 3,  // attribute name, username, value
+};
+
+// Append-only binary log of mutations with group commit.
+//
+// Record: u32 bodyLength, u32 checksum(body), then the body:
+//         u64 sequence, u8 type, u8 fieldCount, { u32 length, bytes }...
+// append() only encodes into a memory buffer; a flusher thread swaps the
+// buffer out, writes it and fdatasyncs it every `commitInterval`, so many
+// mutations share one fsync and appends never wait on the disk. A torn tail
+// (crash mid-write) fails its checksum and ends replay; open() cuts it off so
+// new records are not written behind it.
+class WriteAheadLog {
+public:
+    static constexpr std::chrono::milliseconds commitInterval{10};
+
+    ~WriteAheadLog() { close(); }
+
+    // Open (or create) the log for appending; sequences continue after
+    // `lastSequence`. Anything past `intactBytes` (the end of the last record
+    // replay() accepted) is a torn tail and is truncated away first.
+    bool open(const std::string &logPath, uint64_t lastSequence, uint64_t intactBytes) {
+        close();
+        fd = ::open(logPath.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        off_t end = lseek(fd, 0, SEEK_END);
+        if (end > 0 && static_cast<uint64_t>(end) > intactBytes &&
+            (ftruncate(fd, intactBytes) != 0 || fdatasync(fd) != 0)) {
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        path = logPath;
+        sequence = lastSequence;
+        logBytes = lseek(fd, 0, SEEK_END);
+        stopping = false;
+        flusher = std::thread([this] { flushLoop(); });
+        return true;
+    }
+
+    // Flush outstanding records and stop the flusher
+    void close() {
+        if (!flusher.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        flusher.join();
+        commit();
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    bool isOpen() const { return fd >= 0; }
+
+    // Queue one record for the next group commit; returns its sequence number
+    uint64_t append(LogRecordType type, std::initializer_list<std::string_view> fields) {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint64_t seq = ++sequence;
+        size_t start = buffer.size();
+        buffer.resize(start + 8);
+        putBytes(&seq, sizeof(seq));
+        buffer.push_back(static_cast<char>(type));
+        buffer.push_back(static_cast<char>(fields.size()));
+        for (std::string_view field : fields) {
+            uint32_t length = static_cast<uint32_t>(field.size());
+            putBytes(&length, sizeof(length));
+            buffer.append(field.data(), field.size());
+        }
+        uint32_t bodyLength = static_cast<uint32_t>(buffer.size() - start - 8);
+        uint32_t checksum = checksumOf(buffer.data() + start + 8, bodyLength);
+        memcpy(&buffer[start], &bodyLength, sizeof(bodyLength));
+        memcpy(&buffer[start + 4], &checksum, sizeof(checksum));
+        logBytes += buffer.size() - start;
+        return seq;
+    }
+
+    // Write and fsync everything appended so far; false if that failed (the
+    // records stay queued and every later commit retries them)
+    bool sync() { return commit(); }
+
+    // True once each time the log starts failing to write or sync
+    bool takeFailure() { return failed.exchange(false); }
+
+    // Sync, then move the current file to `archivePath` and start an empty log.
+    // Refuses (returns false) while an earlier archive is still there: its
+    // records are not in any snapshot yet and must not be overwritten.
+    bool rotate(const std::string &archivePath) {
+        std::lock_guard<std::mutex> io(ioMutex);
+        if (!commitBatch() || ::access(archivePath.c_str(), F_OK) == 0 || std::rename(path.c_str(), archivePath.c_str()) != 0) {
+            return false;
+        }
+        int newFd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_TRUNC, 0644);
+        if (newFd < 0) {
+            // Put the file back so `fd` is the live log again; failing that,
+            // stop writing rather than append to an archive that is about to
+            // be deleted
+            if (std::rename(archivePath.c_str(), path.c_str()) != 0) {
+                ::close(fd);
+                fd = -1;
+                commitFailed();
+            }
+            return false;
+        }
+        ::close(fd);
+        fd = newFd;
+        std::lock_guard<std::mutex> lock(mutex);
+        logBytes = buffer.size();
+        return true;
+    }
+
+    uint64_t lastSequence() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sequence;
+    }
+
+    // Bytes in the current log file, including records not yet committed
+    uint64_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return logBytes;
+    }
+
+    // Apply every intact record with sequence > afterSequence, in order.
+    // Returns the highest sequence seen (afterSequence if none); `intactBytes`
+    // receives the offset just past the last intact record.
+    static uint64_t replay(const std::string &logPath, uint64_t afterSequence,
+                           const std::function<void(LogRecordType, const std::vector<std::string_view> &)> &apply,
+                           uint64_t *intactBytes = nullptr) {
+        std::ifstream in(logPath, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        uint64_t last = afterSequence;
+        std::vector<std::string_view> fields;
+        size_t pos = 0;
+        while (data.size() - pos >= 8) {
+            uint32_t bodyLength, checksum;
+            memcpy(&bodyLength, data.data() + pos, 4);
+            memcpy(&checksum, data.data() + pos + 4, 4);
+            if (bodyLength < 10 || data.size() - pos - 8 < bodyLength ||
+                checksumOf(data.data() + pos + 8, bodyLength) != checksum) {
+                break;
+            }
+            const char *body = data.data() + pos + 8;
+            const char *bodyEnd = body + bodyLength;
+            pos += 8 + bodyLength;
+
+            uint64_t seq;
+            memcpy(&seq, body, 8);
+            auto type = static_cast<LogRecordType>(body[8]);
+            uint8_t fieldCount = static_cast<uint8_t>(body[9]);
+            const char *cursor = body + 10;
+            fields.clear();
+            for (uint8_t i = 0; i < fieldCount && bodyEnd - cursor >= 4; ++i) {
+                uint32_t length;
+                memcpy(&length, cursor, 4);
+                cursor += 4;
+                if (static_cast<size_t>(bodyEnd - cursor) < length) {
+                    break;
+                }
+                fields.emplace_back(cursor, length);
+                cursor += length;
+            }
+            if (fields.size() != fieldCount || seq <= afterSequence) {
+                continue;
+            }
+            apply(type, fields);
+            last = std::max(last, seq);
+        }
+        if (intactBytes != nullptr) {
+            *intactBytes = pos;
+        }
+        return last;
+    }
+
+private:
+    std::string path;
+    int fd = -1;
+    uint64_t sequence = 0;
+    uint64_t logBytes = 0;
+    std::string buffer;  // encoded records waiting for the next commit
+    std::string writing; // batch being written (swapped with buffer), kept until it is synced
+    size_t written = 0;  // bytes of `writing` already in the file
+    bool failing = false;             // the last commit failed (guarded by ioMutex)
+    std::atomic<bool> failed{false};  // a commit failed since takeFailure() was last called
+    bool stopping = false;
+    mutable std::mutex mutex; // guards buffer, sequence, logBytes, stopping
+    std::mutex ioMutex;       // serialises writes, fsyncs and rotation of fd
+    std::condition_variable wake;
+    std::thread flusher;
+
+    void putBytes(const void *data, size_t size) { buffer.append(static_cast<const char *>(data), size); }
+
+    static uint32_t checksumOf(const char *data, size_t size) {
+        uint32_t hash = 2166136261u; // FNV-1a
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+        }
+        return hash;
+    }
+
+    bool commit() {
+        std::lock_guard<std::mutex> io(ioMutex);
+        return commitBatch();
+    }
+
+    // Take the pending records and make them durable (caller holds ioMutex).
+    // A batch is only dropped once fdatasync succeeds; after a short write or
+    // a failed sync it stays in `writing`, and the next call carries on from
+    // the first unwritten byte and syncs again.
+    bool commitBatch() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (writing.empty()) {
+                writing.swap(buffer);
+            } else {
+                writing += buffer;
+                buffer.clear();
+            }
+        }
+        if (writing.empty()) {
+            return true;
+        }
+        if (fd < 0) {
+            return commitFailed();
+        }
+        while (written < writing.size()) {
+            ssize_t n = ::write(fd, writing.data() + written, writing.size() - written);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return commitFailed();
+            }
+            written += n;
+        }
+        int synced;
+        do {
+            synced = fdatasync(fd);
+        } while (synced != 0 && errno == EINTR);
+        if (synced != 0) {
+            return commitFailed();
+        }
+        writing.clear();
+        written = 0;
+        failing = false;
+        return true;
+    }
+
+    bool commitFailed() {
+        if (!failing) {
+            failing = true;
+            failed = true;
+        }
+        return false;
+    }
+
+    void flushLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            wake.wait_for(lock, commitInterval);
+            lock.unlock();
+            commit();
+            lock.lock();
+        }
+    }
+};
+
+// Folds the log into a fresh snapshot on a background thread.
+// The caller captures the image and rotates the log on its own thread (so the
+// sequence boundary is exact); the slow write and cleanup happen here.
+class LogCompactor {
+public:
+    ~LogCompactor() { wait(); }
+
+    bool busy() const { return running; }
+
+    // True once per failed compaction: its snapshot could not be written, so
+    // the archive was kept and a later compaction has to retry
+    bool takeFailure() { return failed.exchange(false); }
+
+    void start(SnapshotImage image, const std::string &snapshotPath, const std::string &archivePath) {
+        wait();
+        running = true;
+        worker = std::thread([this, image = std::move(image), snapshotPath, archivePath] {
+            // The image holds every record, archived or not, so a written
+            // snapshot makes the archive redundant even if it predates this run
+            if (writeSnapshot(snapshotPath, image)) {
+                std::remove(archivePath.c_str());
+            } else {
+                failed = true;
+            }
+            running = false;
+        });
+    }
+
+    void wait() {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+private:
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<bool> failed{false};
+};